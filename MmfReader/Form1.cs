@@ -70,6 +70,10 @@ namespace MmfReader
         private void comboBox1_SelectedIndexChanged(object sender, EventArgs e)
         {
             Program.curIndex = comboBox1.SelectedIndex;
+            if (checkBox2.Checked && !StartEmulation())
+            {
+                checkBox2.Checked = false;
+            }
         }
 
         private void checkBox1_CheckStateChanged(object sender, EventArgs e)
@@ -91,5 +95,28 @@ namespace MmfReader
                 Program.writer.CloseFile();
             }
         }
+
+        private void checkBox2_CheckedChanged(object sender, EventArgs e)
+        {
+            if (checkBox2.Checked)
+            {
+                if (!StartEmulation())
+                {
+                    checkBox2.Checked = false;
+                }
+            }
+            else
+            {
+                Program.emulator.Stop();
+            }
+            textBox2.Enabled = !checkBox2.Checked;
+            checkBox3.Enabled = !checkBox2.Checked;
+        }
+
+        private bool StartEmulation()
+        {
+            return int.TryParse(textBox2.Text, out int rate) &&
+                   Program.emulator.Start(Program.curIndex, rate, checkBox3.Checked);
+        }
     }
 }
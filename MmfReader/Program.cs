@@ -2,6 +2,8 @@ using System;
 using System.IO;
 using System.IO.MemoryMappedFiles;
 using System.Runtime.InteropServices;
+using System.Threading;
+using System.Diagnostics;
 using System.Windows.Forms;
 using System.Globalization;
 
@@ -20,41 +22,62 @@ namespace MmfReader
             Application.Run(new Form1());
         }
 
-        public static bool ReadFile(int index, ref MmfData data)
+        public static bool GetFile(int index, out string fileName, out int size)
         {
-            string fileName;
-            int size;
             switch (index)
             {
                 case 1:
                     fileName = "Local\\SimRacingStudioMotionRigPose";
                     size = Marshal.SizeOf<MmfData>();
-                    break;
+                    return true;
                 case 2:
                     fileName = "Local\\motionRigPose";
                     size = Marshal.SizeOf<MmfData>();
-                    break;
+                    return true;
                 case 3:
                     fileName = "Local\\YawVRGEFile";
                     size = Marshal.SizeOf<YawData>();
-                    break;
+                    return true;
                 default:
+                    fileName = "";
+                    size = 0;
                     return false;
             }
+        }
+
+        public static bool ReadFile(int index, ref MmfData data)
+        {
+            if (!GetFile(index, out string fileName, out int size))
+            {
+                return false;
+            }
             try
             {
                 using MemoryMappedFile file = MemoryMappedFile.OpenExisting(fileName);
-                using MemoryMappedViewAccessor accessor = file.CreateViewAccessor(0, size);
+                using MemoryMappedViewAccessor accessor = file.CreateViewAccessor();
+                long offset = 0;
+                if (accessor.Capacity >= Marshal.SizeOf<SequenceHeader>())
+                {
+                    accessor.Read(0, out SequenceHeader header);
+                    if (SequenceHeader.Magic == header.magic && SequenceHeader.Version == header.version)
+                    {
+                        offset = header.payloadOffset;
+                    }
+                }
+                if (accessor.Capacity < offset + size)
+                {
+                    return false;
+                }
                 bool success = false;
                 switch (index)
                 {
                     case 1:
                     case 2:
-                        accessor.Read(0, out data);
+                        accessor.Read(offset, out data);
                         success = true;
                         break;
                     case 3:
-                        accessor.Read(0, out YawData yaw);
+                        accessor.Read(offset, out YawData yaw);
                         data.sway = 0;
                         data.surge = 0;
                         data.heave = 0;
@@ -76,6 +99,7 @@ namespace MmfReader
 
         public static int curIndex = 0;
         public static CsvWriter writer = new();
+        public static MmfWriter emulator = new();
     }
 
     class WorkerArguments
@@ -90,6 +114,19 @@ namespace MmfReader
         public MmfData Data { get; set; }
     }
 
+    // optional header preceding the payload, allowing the api layer to detect and retry torn reads
+    // the sequence is odd while payload and timestamp are written
+    public struct SequenceHeader
+    {
+        public const ulong Magic = 0x514553434d52584f; // "OXRMCSEQ"
+        public const uint Version = 1;
+
+        public ulong magic;
+        public uint version, payloadOffset;
+        public ulong sequence;
+        public long timestamp;
+    }
+
     public struct MmfData
     {
         public double sway, surge, heave, yaw, roll, pitch;
@@ -102,6 +139,138 @@ namespace MmfReader
         public float autoX, autoY;
     };
 
+    // emulates motion software by creating the memory mapped file of the selected virtual tracker and writing
+    // synthetic motion (overlapping sine waves) into it, using the same struct layout as the original software
+    public class MmfWriter : IDisposable
+    {
+        MemoryMappedFile file = null;
+        MemoryMappedViewAccessor accessor = null;
+        Thread thread = null;
+        volatile bool running = false;
+        long offset = 0;
+        ulong sequence = 0;
+
+        public bool Start(int index, int rate, bool sequenced)
+        {
+            Stop();
+            if (rate <= 0 || !Program.GetFile(index, out string fileName, out int size))
+            {
+                return false;
+            }
+            offset = sequenced ? Marshal.SizeOf<SequenceHeader>() : 0;
+            try
+            {
+                file = MemoryMappedFile.CreateOrOpen(fileName, offset + size);
+                accessor = file.CreateViewAccessor(0, offset + size);
+                if (sequenced)
+                {
+                    SequenceHeader header = new SequenceHeader
+                    {
+                        magic = SequenceHeader.Magic,
+                        version = SequenceHeader.Version,
+                        payloadOffset = (uint)offset
+                    };
+                    accessor.Write(0, ref header);
+                    sequence = 0;
+                }
+            }
+            catch (Exception)
+            {
+                Stop();
+                return false;
+            }
+            running = true;
+            thread = new Thread(() => Run(index, rate))
+            {
+                IsBackground = true,
+                Priority = ThreadPriority.AboveNormal
+            };
+            thread.Start();
+            return true;
+        }
+
+        public void Stop()
+        {
+            running = false;
+            thread?.Join();
+            thread = null;
+            accessor?.Dispose();
+            accessor = null;
+            file?.Dispose();
+            file = null;
+        }
+
+        public void Dispose()
+        {
+            Stop();
+        }
+
+        void Run(int index, int rate)
+        {
+            Stopwatch clock = Stopwatch.StartNew();
+            double period = 1000.0 / rate;
+            double next = 0;
+            while (running)
+            {
+                double t = clock.Elapsed.TotalSeconds;
+                MmfData data = Generate(t);
+                if (offset > 0)
+                {
+                    accessor.Write(16, ++sequence);
+                    Thread.MemoryBarrier();
+                }
+                if (3 == index)
+                {
+                    YawData yaw = new YawData
+                    {
+                        yaw = (float)data.yaw,
+                        pitch = (float)data.pitch,
+                        roll = (float)data.roll
+                    };
+                    accessor.Write(offset, ref yaw);
+                }
+                else
+                {
+                    accessor.Write(offset, ref data);
+                }
+                if (offset > 0)
+                {
+                    // Stopwatch uses the performance counter, like the reader
+                    accessor.Write(24, Stopwatch.GetTimestamp());
+                    Thread.MemoryBarrier();
+                    accessor.Write(16, ++sequence);
+                }
+
+                // schedule on absolute time to keep the average rate despite the coarse sleep granularity
+                next += period;
+                double remaining = next - clock.Elapsed.TotalMilliseconds;
+                if (remaining > 0)
+                {
+                    Thread.Sleep((int)remaining);
+                }
+                else if (remaining < -100 * period)
+                {
+                    // don't try to catch up after being suspended
+                    next = clock.Elapsed.TotalMilliseconds;
+                }
+            }
+        }
+
+        // rotations in degree, translations in millimeter
+        static MmfData Generate(double t)
+        {
+            return new MmfData
+            {
+                sway = 30.0 * Math.Sin(2 * Math.PI * 0.4 * t),
+                surge = 50.0 * Math.Sin(2 * Math.PI * 0.25 * t + 1.0),
+                heave = 20.0 * Math.Sin(2 * Math.PI * 1.5 * t) + 5.0 * Math.Sin(2 * Math.PI * 8.0 * t),
+                yaw = 20.0 * Math.Sin(2 * Math.PI * 0.1 * t),
+                roll = 10.0 * Math.Sin(2 * Math.PI * 0.5 * t + 2.0),
+                pitch = 10.0 * Math.Sin(2 * Math.PI * 0.3 * t) + 1.0 * Math.Sin(2 * Math.PI * 5.0 * t)
+            };
+        }
+    }
+
     public class CsvWriter: IDisposable
     {
         StreamWriter writer = null;
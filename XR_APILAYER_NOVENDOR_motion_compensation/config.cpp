@@ -3,7 +3,6 @@
 #include "pch.h"
 
 #include "config.h"
-#include "layer.h"
 #include "output.h"
 #include <log.h>
 
@@ -24,7 +23,7 @@ bool ConfigManager::Init(const std::string& application)
         return false;
     }
     m_UsesOpenComposite = application.rfind("OpenComposite", 0) == 0;
-    m_ApplicationIni = localAppData.string() + "\\" + application + ".ini";
+    m_ApplicationIni = (localAppData / (application + ".ini")).string();
     if (!application.empty() && _access(m_ApplicationIni.c_str(), 0) == -1)
     {
         if (!WritePrivateProfileString(enabledKey->second.first.c_str(),
@@ -39,7 +38,7 @@ bool ConfigManager::Init(const std::string& application)
                      LastErrorMsg().c_str());
         }
     }
-    const std::string coreIni(localAppData.string() + "\\" + "OpenXR-MotionCompensation.ini");
+    const std::string coreIni((localAppData / "OpenXR-MotionCompensation.ini").string());
     if ((_access(coreIni.c_str(), 0)) != -1)
     {
         // check global deactivation flag
@@ -126,7 +125,7 @@ bool ConfigManager::GetBool(const Cfg key, bool& val)
             ErrorLog("%s: unable to convert value (%s) for key (%s) to integer: %s",
                      __FUNCTION__,
                      strVal.c_str(),
-                     m_Keys[key].first,
+                     m_Keys[key].first.c_str(),
                      e.what());
         }
     }
@@ -244,7 +243,7 @@ bool ConfigManager::IsVirtualTracker()
 {
     std::string type;
     GetString(Cfg::TrackerType, type);
-    return "srs" == type || "flypt" == type || "yaw" == type;
+    return "srs" == type || "flypt" == type || "yaw" == type || "replay" == type || "synthetic" == type;
 }
 
 std::string ConfigManager::GetControllerSide()
@@ -296,7 +295,7 @@ void ConfigManager::WriteConfig(const bool forApp)
 
     bool error{false};
     const std::string configFile =
-        forApp ? m_ApplicationIni : localAppData.string() + "\\" + "OpenXR-MotionCompensation.ini";
+        forApp ? m_ApplicationIni : (localAppData / "OpenXR-MotionCompensation.ini").string();
     for (const auto key : m_KeysToSave)
     {
         if (const auto& keyEntry = m_Keys.find(key); m_Keys.end() != keyEntry)
@@ -333,7 +332,7 @@ void ConfigManager::WriteConfig(const bool forApp)
             else
             {
                 error = true;
-                ErrorLog("%s: key not found in value map: %d:%s", __FUNCTION__, section.c_str(), keyName.c_str());
+                ErrorLog("%s: key not found in value map: %s:%s", __FUNCTION__, section.c_str(), keyName.c_str());
             }
         }
         else
@@ -1,6 +1,7 @@
 // Copyright(c) 2022 Sebastian Veith
 
 #pragma once
+#include "globals.h"
 
 enum class Cfg
 {
@@ -21,6 +22,11 @@ enum class Cfg
     TrackerOffsetRight,
     TrackerOffsetYaw,
     TrackerConstantPitch,
+    TrackerReplayFile,
+    TrackerSyntheticSignal,
+    TrackerSyntheticRate,
+    TrackerSyntheticNoise,
+    TrackerSyntheticDropouts,
     UseYawGeOffset,
     LegacyMode,
     CorX,
@@ -32,11 +38,21 @@ enum class Cfg
     CorD,
     LoadRefPoseFromFile,
     MarkerSize,
+    TransType,
     TransStrength,
     TransOrder,
     TransVerticalFactor,
+    TransTimeBased,
+    TransBeta,
+    TransProcessNoise,
+    TransMeasurementNoise,
+    RotType,
     RotStrength,
     RotOrder,
+    RotTimeBased,
+    RotBeta,
+    RotProcessNoise,
+    RotMeasurementNoise,
     StabilizerEnabled,
     StabilizerStrength,
     StabilizerRoll,
@@ -45,6 +61,20 @@ enum class Cfg
     StabilizerSurge,
     StabilizerSway,
     StabilizerHeave,
+    StabilizerOrder,
+    StabilizerAutoTune,
+    StabilizerNotchRoll,
+    StabilizerNotchPitch,
+    StabilizerNotchYaw,
+    StabilizerNotchSurge,
+    StabilizerNotchSway,
+    StabilizerNotchHeave,
+    StabilizerNotchBandwidth,
+    StabilizerInterval,
+    StabilizerPreciseTiming,
+    StabilizerSpinBudget,
+    StabilizerChangeDriven,
+    StabilizerExtrapolation,
     FactorEnabled,
     FactorTrackerRoll,
     FactorTrackerPitch,
@@ -60,6 +90,10 @@ enum class Cfg
     FactorHmdHeave,
     CacheUseEye,
     CacheTolerance,
+    CacheRingBuffer,
+    CacheInterpolation,
+    CacheExtrapolation,
+    CacheStatistics,
     KeyActivate,
     KeyCalibrate,
     KeyTransInc,
@@ -90,6 +124,9 @@ enum class Cfg
     KeyRecorder,
     TestRotation,
     RecordSamples,
+    RecordEvaluation,
+    PipelineTiming,
+    SamplerStatistics,
     LogVerbose
 };
 
@@ -140,6 +177,11 @@ class ConfigManager
 
         {Cfg::UseYawGeOffset, {"tracker", "use_yaw_ge_offset"}},
         {Cfg::TrackerConstantPitch, {"tracker", "constant_pitch_angle"}},
+        {Cfg::TrackerReplayFile, {"tracker", "replay_file"}},
+        {Cfg::TrackerSyntheticSignal, {"tracker", "synthetic_signal"}},
+        {Cfg::TrackerSyntheticRate, {"tracker", "synthetic_rate"}},
+        {Cfg::TrackerSyntheticNoise, {"tracker", "synthetic_noise"}},
+        {Cfg::TrackerSyntheticDropouts, {"tracker", "synthetic_dropouts"}},
 
         {Cfg::LegacyMode, {"tracker", "legacy_mode"}},
 
@@ -154,11 +196,21 @@ class ConfigManager
 
         {Cfg::MarkerSize, {"tracker", "marker_size"}},
 
+        {Cfg::TransType, {"translation_filter", "type"}},
         {Cfg::TransStrength, {"translation_filter", "strength"}},
         {Cfg::TransOrder, {"translation_filter", "order"}},
         {Cfg::TransVerticalFactor, {"translation_filter", "vertical_factor"}},
+        {Cfg::TransTimeBased, {"translation_filter", "time_based"}},
+        {Cfg::TransBeta, {"translation_filter", "one_euro_beta"}},
+        {Cfg::TransProcessNoise, {"translation_filter", "kalman_process_noise"}},
+        {Cfg::TransMeasurementNoise, {"translation_filter", "kalman_measurement_noise"}},
+        {Cfg::RotType, {"rotation_filter", "type"}},
         {Cfg::RotStrength, {"rotation_filter", "strength"}},
         {Cfg::RotOrder, {"rotation_filter", "order"}},
+        {Cfg::RotTimeBased, {"rotation_filter", "time_based"}},
+        {Cfg::RotBeta, {"rotation_filter", "one_euro_beta"}},
+        {Cfg::RotProcessNoise, {"rotation_filter", "kalman_process_noise"}},
+        {Cfg::RotMeasurementNoise, {"rotation_filter", "kalman_measurement_noise"}},
 
         {Cfg::StabilizerEnabled, {"input_stabilizer", "enabled"}},
         {Cfg::StabilizerStrength, {"input_stabilizer", "strength"}},
@@ -168,6 +220,20 @@ class ConfigManager
         {Cfg::StabilizerSurge, {"input_stabilizer", "surge"}},
         {Cfg::StabilizerSway, {"input_stabilizer", "sway"}},
         {Cfg::StabilizerHeave, {"input_stabilizer", "heave"}},
+        {Cfg::StabilizerOrder, {"input_stabilizer", "order"}},
+        {Cfg::StabilizerAutoTune, {"input_stabilizer", "auto_tune"}},
+        {Cfg::StabilizerNotchRoll, {"input_stabilizer", "notch_roll"}},
+        {Cfg::StabilizerNotchPitch, {"input_stabilizer", "notch_pitch"}},
+        {Cfg::StabilizerNotchYaw, {"input_stabilizer", "notch_yaw"}},
+        {Cfg::StabilizerNotchSurge, {"input_stabilizer", "notch_surge"}},
+        {Cfg::StabilizerNotchSway, {"input_stabilizer", "notch_sway"}},
+        {Cfg::StabilizerNotchHeave, {"input_stabilizer", "notch_heave"}},
+        {Cfg::StabilizerNotchBandwidth, {"input_stabilizer", "notch_bandwidth"}},
+        {Cfg::StabilizerInterval, {"input_stabilizer", "sample_interval"}},
+        {Cfg::StabilizerPreciseTiming, {"input_stabilizer", "precise_timing"}},
+        {Cfg::StabilizerSpinBudget, {"input_stabilizer", "spin_budget"}},
+        {Cfg::StabilizerChangeDriven, {"input_stabilizer", "change_driven"}},
+        {Cfg::StabilizerExtrapolation, {"input_stabilizer", "extrapolation_limit"}},
 
         {Cfg::FactorEnabled, {"pose_modifier", "enabled"}},
         {Cfg::FactorTrackerRoll, {"pose_modifier", "tracker_roll"}},
@@ -185,6 +251,10 @@ class ConfigManager
 
         {Cfg::CacheUseEye, {"cache", "use_eye_cache"}},
         {Cfg::CacheTolerance, {"cache", "tolerance"}},
+        {Cfg::CacheRingBuffer, {"cache", "ring_buffer"}},
+        {Cfg::CacheInterpolation, {"cache", "interpolation"}},
+        {Cfg::CacheExtrapolation, {"cache", "extrapolation_limit"}},
+        {Cfg::CacheStatistics, {"cache", "statistics_interval"}},
 
         {Cfg::KeyActivate, {"shortcuts", "activate"}},
         {Cfg::KeyCalibrate, {"shortcuts", "calibrate"}},
@@ -227,7 +297,10 @@ class ConfigManager
 
         {Cfg::LogVerbose, {"debug", "log_verbose"}},
         {Cfg::RecordSamples, {"debug", "record_stabilizer_samples"}},
-        {Cfg::TestRotation, {"debug", "testrotation"}}};
+        {Cfg::RecordEvaluation, {"debug", "evaluate_recording"}},
+        {Cfg::TestRotation, {"debug", "testrotation"}},
+        {Cfg::PipelineTiming, {"debug", "pipeline_timing_interval"}},
+        {Cfg::SamplerStatistics, {"debug", "sampler_statistics_interval"}}};
 
 
     std::set<Cfg> m_KeysToSave{Cfg::TransStrength,
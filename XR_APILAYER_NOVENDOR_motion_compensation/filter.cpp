@@ -12,200 +12,590 @@ using namespace utility;
 
 namespace filter
 {
-    SingleEmaFilter::SingleEmaFilter(const float strength) : FilterBase(strength, "translational")
+    static std::string ToString(DirectX::FXMVECTOR vector)
+    {
+        XrVector3f value;
+        StoreXrVector3(&value, vector);
+        return xr::ToString(value);
+    }
+
+    // slerp is replaced by normalized lerp for rotational differences below 10 degrees (per frame differences usually
+    // are much smaller), the resulting error of the interpolated rotation angle stays below 2.2e-5 rad (~ angle^3 / 250)
+    static XrQuaternionf FastSlerp(const XrQuaternionf& from, const XrQuaternionf& to, const float alpha)
+    {
+        // cosine of half the maximum rotation angle
+        constexpr float threshold{0.9961947f};
+
+        const DirectX::XMVECTOR first = LoadXrQuaternion(from);
+        DirectX::XMVECTOR second = LoadXrQuaternion(to);
+        const float cosine = DirectX::XMVectorGetX(DirectX::XMQuaternionDot(first, second));
+        if (std::abs(cosine) < threshold)
+        {
+            return Quaternion::Slerp(from, to, alpha);
+        }
+        if (cosine < 0.0f)
+        {
+            // use shorter path
+            second = DirectX::XMVectorNegate(second);
+        }
+        XrQuaternionf result;
+        StoreXrQuaternion(&result, DirectX::XMQuaternionNormalize(DirectX::XMVectorLerp(first, second, alpha)));
+        return result;
+    }
+
+    template <typename Stages>
+    static std::string StagesToString(const Stages& stages)
+    {
+        std::string result;
+        for (const auto& stage : stages)
+        {
+            if constexpr (std::is_same_v<typename Stages::value_type, XrQuaternionf>)
+            {
+                result += (result.empty() ? "" : ", ") + xr::ToString(stage);
+            }
+            else
+            {
+                result += (result.empty() ? "" : ", ") + ToString(stage);
+            }
+        }
+        return result;
+    }
+
+    template <size_t Order>
+    EmaFilter<Order>::EmaFilter(const float strength) : FilterBase(strength, "translational")
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local, "SingleEmaFilter::SingleEmaFilter", TLArg(strength, "Strength"));
+        TraceLoggingWriteStart(local, "EmaFilter::EmaFilter", TLArg(strength, "Strength"), TLArg(Order, "Order"));
 
         GetConfig()->GetFloat(Cfg::TransVerticalFactor, m_VerticalFactor);
         m_VerticalFactor = std::max(0.0f, m_VerticalFactor);
-        openxr_api_layer::log::DebugLog("%s filter vertical factor set: %f", m_Type.c_str(), m_VerticalFactor);
-        SingleEmaFilter::SetStrength(m_Strength);
+        DebugLog("%s filter vertical factor set: %f", m_Type, m_VerticalFactor);
+        SetStrength(m_Strength);
 
-        TraceLoggingWriteStop(local, "SingleEmaFilter::SingleEmaFilter", TLArg(m_VerticalFactor, "VerticalFactor"));
+        TraceLoggingWriteStop(local, "EmaFilter::EmaFilter", TLArg(m_VerticalFactor, "VerticalFactor"));
     }
 
-    XrVector3f SingleEmaFilter::EmaFunction(const XrVector3f current, const XrVector3f stored) const
+    template <size_t Order>
+    DirectX::XMVECTOR XM_CALLCONV EmaFilter<Order>::EmaFunction(DirectX::FXMVECTOR current,
+                                                                DirectX::FXMVECTOR stored) const
     {
-        return m_Alpha * current + m_OneMinusAlpha * stored;
+        return DirectX::XMVectorMultiplyAdd(m_Alpha, current, DirectX::XMVectorMultiply(m_OneMinusAlpha, stored));
     }
 
-    float SingleEmaFilter::SetStrength(const float strength)
+    template <size_t Order>
+    float EmaFilter<Order>::SetStrength(const float strength)
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local, "SingleEmaFilter::SetStrength", TLArg(strength, "Strength"));
+        TraceLoggingWriteStart(local, "EmaFilter::SetStrength", TLArg(strength, "Strength"));
 
         FilterBase::SetStrength(strength);
-        m_Alpha = {1.0f - m_Strength, std::max(0.f, 1.0f - (m_VerticalFactor * m_Strength)), 1.0f - m_Strength};
-        m_OneMinusAlpha = {1.f - m_Alpha.x, 1.f - m_Alpha.y, 1.f - m_Alpha.z};
+        m_VerticalStrength = std::min(1.f, m_VerticalFactor * m_Strength);
+        SetAlpha(1.f);
 
         TraceLoggingWriteStop(local,
-                              "SingleEmaFilter::SetStrength",
-                              TLArg(xr::ToString(m_Alpha).c_str(), "Alpha"),
-                              TLArg(xr::ToString(m_OneMinusAlpha).c_str(), "OneMinusAlpha"));
+                              "EmaFilter::SetStrength",
+                              TLArg(ToString(m_Alpha).c_str(), "Alpha"),
+                              TLArg(ToString(m_OneMinusAlpha).c_str(), "OneMinusAlpha"));
 
         return m_Strength;
     }
 
-    void SingleEmaFilter::ApplyFilter(XrVector3f& location)
+    template <size_t Order>
+    void EmaFilter<Order>::SetAlpha(const float exponent)
+    {
+        const float strength = 1.f == exponent ? m_Strength : std::pow(m_Strength, exponent);
+        const float verticalStrength = 1.f == exponent ? m_VerticalStrength : std::pow(m_VerticalStrength, exponent);
+        m_OneMinusAlpha = DirectX::XMVectorSet(strength, verticalStrength, strength, 0.f);
+        m_Alpha = DirectX::XMVectorSubtract(DirectX::XMVectorSet(1.f, 1.f, 1.f, 0.f), m_OneMinusAlpha);
+    }
+
+    template <size_t Order>
+    void EmaFilter<Order>::ApplyFilter(XrVector3f& location, const XrTime time)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local,
-                               "SingleEmaFilter::ApplyFilter",
+                               "EmaFilter::ApplyFilter",
+                               TLArg(Order, "Order"),
+                               TLArg(time, "Time"),
                                TLArg(xr::ToString(location).c_str(), "location"),
-                               TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"),
-                               TLArg(xr::ToString(this->m_Alpha).c_str(), "m_Alpha"));
+                               TLArg(StagesToString(m_Stages).c_str(), "m_Stages"));
+
+        if (m_TimeBased)
+        {
+            SetAlpha(Exponent(time));
+        }
+        TraceLoggingWriteTagged(local, "EmaFilter::ApplyFilter", TLArg(ToString(m_Alpha).c_str(), "m_Alpha"));
 
-        m_Ema = EmaFunction(location, m_Ema);
-        location = m_Ema;
+        // all stages are calculated in registers, each one smoothing the output of the previous one
+        DirectX::XMVECTOR current = LoadXrVector3(location);
+        for (size_t i = 0; i < Order; i++)
+        {
+            current = EmaFunction(current, m_Stages[i]);
+            m_Stages[i] = current;
+        }
+        if constexpr (1 == Order)
+        {
+            StoreXrVector3(&location, m_Stages[0]);
+        }
+        else if constexpr (2 == Order)
+        {
+            // 2 * ema - emaEma
+            StoreXrVector3(&location,
+                           DirectX::XMVectorSubtract(DirectX::XMVectorAdd(m_Stages[0], m_Stages[0]), m_Stages[1]));
+        }
+        else
+        {
+            // 3 * ema - 3 * emaEma + emaEmaEma
+            static const DirectX::XMVECTORF32 three{{{3.f, 3.f, 3.f, 3.f}}};
+            StoreXrVector3(
+                &location,
+                DirectX::XMVectorMultiplyAdd(DirectX::XMVectorSubtract(m_Stages[0], m_Stages[1]), three, m_Stages[2]));
+        }
 
         TraceLoggingWriteStop(local,
-                              "SingleEmaFilter::ApplyFilter",
+                              "EmaFilter::ApplyFilter",
                               TLArg(xr::ToString(location).c_str(), "location"),
-                              TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"));
+                              TLArg(StagesToString(m_Stages).c_str(), "m_Stages"));
     }
 
-    void SingleEmaFilter::Reset(const XrVector3f& location)
+    template <size_t Order>
+    void EmaFilter<Order>::Reset(const XrVector3f& location)
     {
-        m_Ema = location;
+        m_Stages.fill(LoadXrVector3(location));
+        m_LastTime = 0;
     }
 
-    void DoubleEmaFilter::ApplyFilter(XrVector3f& location)
+    template <size_t Order>
+    void SlerpFilter<Order>::ApplyFilter(XrQuaternionf& rotation, const XrTime time)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local,
-                               "DoubleEmaFilter::ApplyFilter",
-                               TLArg(xr::ToString(location).c_str(), "location"),
-                               TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"),
-                               TLArg(xr::ToString(this->m_EmaEma).c_str(), "m_EmaEma"),
-                               TLArg(xr::ToString(this->m_Alpha).c_str(), "m_Alpha"));
+                               "SlerpFilter::ApplyFilter",
+                               TLArg(Order, "Order"),
+                               TLArg(time, "Time"),
+                               TLArg(xr::ToString(rotation).c_str(), "rotation"),
+                               TLArg(StagesToString(m_Stages).c_str(), "m_Stages"),
+                               TLArg(std::to_string(m_Strength).c_str(), "m_Strength"));
 
-        m_Ema = EmaFunction(location, m_Ema);
-        m_EmaEma = EmaFunction(m_Ema, m_EmaEma);
-        location = XrVector3f{2, 2, 2} * m_Ema - m_EmaEma;
+        const float exponent = Exponent(time);
+        const float strength = 1.f == exponent ? m_Strength : std::pow(m_Strength, exponent);
+        for (XrQuaternionf& stage : m_Stages)
+        {
+            stage = FastSlerp(rotation, stage, strength);
+            rotation = stage;
+        }
 
         TraceLoggingWriteStop(local,
-                              "DoubleEmaFilter::ApplyFilter",
-                              TLArg(xr::ToString(location).c_str(), "location"),
-                              TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"),
-                              TLArg(xr::ToString(this->m_EmaEma).c_str(), "m_EmaEma"));
+                              "SlerpFilter::ApplyFilter",
+                              TLArg(xr::ToString(rotation).c_str(), "rotation"),
+                              TLArg(StagesToString(m_Stages).c_str(), "m_Stages"));
     }
 
-    void DoubleEmaFilter::Reset(const XrVector3f& location)
+    template <size_t Order>
+    void SlerpFilter<Order>::Reset(const XrQuaternionf& rotation)
     {
-        SingleEmaFilter::Reset(location);
-        m_EmaEma = location;
+        m_Stages.fill(rotation);
+        m_LastTime = 0;
     }
 
-    void TripleEmaFilter::ApplyFilter(XrVector3f& location)
+    template <typename Value>
+    OneEuroFilter<Value>::OneEuroFilter(const float strength)
+        : FilterBase<Value>(strength, std::is_same_v<Value, XrVector3f> ? "translational" : "rotational")
     {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local,
-                               "TripleEmaFilter::ApplyFilter",
-                               TLArg(xr::ToString(location).c_str(), "location"),
-                               TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"),
-                               TLArg(xr::ToString(this->m_EmaEma).c_str(), "m_EmaEma"),
-                               TLArg(xr::ToString(this->m_EmaEmaEma).c_str(), "m_EmaEmaEma"),
-                               TLArg(xr::ToString(this->m_Alpha).c_str(), "m_Alpha"));
+        TraceLoggingWriteStart(local, "OneEuroFilter::OneEuroFilter", TLArg(strength, "Strength"));
 
-        m_Ema = EmaFunction(location, m_Ema);
-        m_EmaEma = EmaFunction(m_Ema, m_EmaEma);
-        m_EmaEmaEma = EmaFunction(m_EmaEma, m_EmaEmaEma);
-        constexpr XrVector3f three{3, 3, 3};
-        location = three * m_Ema - three * m_EmaEma + m_EmaEmaEma;
+        GetConfig()->GetFloat(std::is_same_v<Value, XrVector3f> ? Cfg::TransBeta : Cfg::RotBeta, m_Beta);
+        m_Beta = std::max(0.0f, m_Beta);
+        Log("%s one euro filter beta set: %f", this->m_Type, m_Beta);
+        SetStrength(this->m_Strength);
 
-        TraceLoggingWriteStop(local,
-                              "TripleEmaFilter::ApplyFilter",
-                              TLArg(xr::ToString(location).c_str(), "location"),
-                              TLArg(xr::ToString(this->m_Ema).c_str(), "m_Ema"),
-                              TLArg(xr::ToString(this->m_EmaEma).c_str(), "m_EmaEma"),
-                              TLArg(xr::ToString(this->m_EmaEmaEma).c_str(), "m_EmaEmaEma"));
+        TraceLoggingWriteStop(local, "OneEuroFilter::OneEuroFilter", TLArg(m_Beta, "Beta"));
     }
 
-    void TripleEmaFilter::Reset(const XrVector3f& location)
+    template <typename Value>
+    float OneEuroFilter<Value>::SetStrength(const float strength)
     {
-        DoubleEmaFilter::Reset(location);
-        m_EmaEmaEma = location;
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "OneEuroFilter::SetStrength", TLArg(strength, "Strength"));
+
+        FilterBase<Value>::SetStrength(strength);
+
+        // minimum cutoff matches the cutoff of an ema filter with the same strength at reference rate
+        m_MinCutoff = this->m_Strength < 1.0f ? -std::log(this->m_Strength) * 1000000000.0f /
+                                                    (static_cast<float>(this->referenceInterval) * 2.0f * floatPi)
+                                              : 0.0f;
+        DebugLog("%s one euro filter minimum cutoff: %f Hz", this->m_Type, m_MinCutoff);
+
+        TraceLoggingWriteStop(local, "OneEuroFilter::SetStrength", TLArg(m_MinCutoff, "MinCutoff"));
+
+        return this->m_Strength;
     }
 
-    void SingleSlerpFilter::ApplyFilter(XrQuaternionf& rotation)
+    template <typename Value>
+    void OneEuroFilter<Value>::ApplyFilter(Value& value, const XrTime time)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local,
-                               "SingleSlerpFilter::ApplyFilter",
-                               TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                               TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"),
-                               TLArg(std::to_string(this->m_Strength).c_str(), "m_Strength"));
+                               "OneEuroFilter::ApplyFilter",
+                               TLArg(time, "Time"),
+                               TLArg(xr::ToString(value).c_str(), "Value"),
+                               TLArg(xr::ToString(m_Filtered).c_str(), "Filtered"),
+                               TLArg(m_Speed, "Speed"));
+
+        const XrTime previous = this->m_LastTime;
+        if (time <= previous)
+        {
+            // out of order sample
+            value = m_Filtered;
+            TraceLoggingWriteStop(local, "OneEuroFilter::ApplyFilter", TLArg(false, "InOrder"));
+            return;
+        }
+        this->m_LastTime = time;
+        if (0 == previous)
+        {
+            Reset(value);
+            this->m_LastTime = time;
+            TraceLoggingWriteStop(local, "OneEuroFilter::ApplyFilter", TLArg(true, "Initial"));
+            return;
+        }
 
-        m_FirstStage = Quaternion::Slerp(rotation, m_FirstStage, m_Strength);
-        rotation = m_FirstStage;
+        const float interval = static_cast<float>(std::min(time - previous, this->maxInterval)) / 1000000000.0f;
+        m_Speed += Alpha(derivativeCutoff, interval) * (Distance(value) / interval - m_Speed);
+        const float cutoff = m_MinCutoff + m_Beta * m_Speed;
+        m_Filtered = Smooth(value, Alpha(cutoff, interval));
+        value = m_Filtered;
 
         TraceLoggingWriteStop(local,
-                              "SingleSlerpFilter::ApplyFilter",
-                              TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                              TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"));
+                              "OneEuroFilter::ApplyFilter",
+                              TLArg(xr::ToString(value).c_str(), "Value"),
+                              TLArg(m_Speed, "Speed"),
+                              TLArg(cutoff, "Cutoff"));
     }
 
-    void SingleSlerpFilter::Reset(const XrQuaternionf& rotation)
+    template <typename Value>
+    void OneEuroFilter<Value>::Reset(const Value& value)
     {
-        m_FirstStage = rotation;
+        m_Filtered = value;
+        m_Speed = 0.0f;
+        this->m_LastTime = 0;
     }
 
-    void DoubleSlerpFilter::ApplyFilter(XrQuaternionf& rotation)
+    template <typename Value>
+    float OneEuroFilter<Value>::Alpha(const float cutoff, const float interval)
     {
-        TraceLocalActivity(local);
-        TraceLoggingWriteStart(local,
-                               "DoubleSlerpFilter::ApplyFilter",
-                               TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                               TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"),
-                               TLArg(xr::ToString(this->m_SecondStage).c_str(), "m_SecondStage"),
-                               TLArg(std::to_string(this->m_Strength).c_str(), "m_Strength"));
+        // equals 1 / (1 + tau / interval) with tau = 1 / (2 * pi * cutoff)
+        const float rate = 2.0f * floatPi * cutoff * interval;
+        return rate / (1.0f + rate);
+    }
 
-        m_FirstStage = Quaternion::Slerp(rotation, m_FirstStage, m_Strength);
-        m_SecondStage = Quaternion::Slerp(m_FirstStage, m_SecondStage, m_Strength);
-        rotation = m_SecondStage;
+    template <>
+    float OneEuroFilter<XrVector3f>::Distance(const XrVector3f& value) const
+    {
+        return DirectX::XMVectorGetX(
+            DirectX::XMVector3Length(DirectX::XMVectorSubtract(LoadXrVector3(value), LoadXrVector3(m_Filtered))));
+    }
+
+    template <>
+    float OneEuroFilter<XrQuaternionf>::Distance(const XrQuaternionf& value) const
+    {
+        // rotation angle between filtered and current orientation
+        const float dot = std::abs(DirectX::XMVectorGetX(
+            DirectX::XMQuaternionDot(LoadXrQuaternion(value), LoadXrQuaternion(m_Filtered))));
+        return 2.0f * std::acos(std::min(1.0f, dot));
+    }
+
+    template <>
+    XrVector3f OneEuroFilter<XrVector3f>::Smooth(const XrVector3f& value, const float alpha) const
+    {
+        XrVector3f result;
+        StoreXrVector3(&result, DirectX::XMVectorLerp(LoadXrVector3(m_Filtered), LoadXrVector3(value), alpha));
+        return result;
+    }
+
+    template <>
+    XrQuaternionf OneEuroFilter<XrQuaternionf>::Smooth(const XrQuaternionf& value, const float alpha) const
+    {
+        return FastSlerp(m_Filtered, value, alpha);
+    }
+
+    template <typename Value>
+    KalmanFilter<Value>::KalmanFilter(const float strength)
+        : FilterBase<Value>(strength, std::is_same_v<Value, XrVector3f> ? "translational" : "rotational")
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "KalmanFilter::KalmanFilter", TLArg(strength, "Strength"));
+
+        constexpr bool trans = std::is_same_v<Value, XrVector3f>;
+        GetConfig()->GetFloat(trans ? Cfg::TransProcessNoise : Cfg::RotProcessNoise, m_ProcessNoise);
+        GetConfig()->GetFloat(trans ? Cfg::TransMeasurementNoise : Cfg::RotMeasurementNoise, m_MeasurementNoise);
+        m_ProcessNoise = std::max(std::numeric_limits<float>::min(), m_ProcessNoise);
+        m_MeasurementNoise = std::max(std::numeric_limits<float>::min(), m_MeasurementNoise);
+        Log("%s kalman filter noise set: process = %f, measurement = %f",
+            this->m_Type,
+            m_ProcessNoise,
+            m_MeasurementNoise);
+        SetStrength(this->m_Strength);
+        if constexpr (!trans)
+        {
+            m_Estimate = Quaternion::Identity();
+        }
 
         TraceLoggingWriteStop(local,
-                              "DoubleSlerpFilter::ApplyFilter",
-                              TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                              TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"),
-                              TLArg(xr::ToString(this->m_SecondStage).c_str(), "m_SecondStage"));
+                              "KalmanFilter::KalmanFilter",
+                              TLArg(m_ProcessNoise, "ProcessNoise"),
+                              TLArg(m_MeasurementNoise, "MeasurementNoise"));
     }
 
-    void DoubleSlerpFilter::Reset(const XrQuaternionf& rotation)
+    template <typename Value>
+    float KalmanFilter<Value>::SetStrength(const float strength)
     {
-        SingleSlerpFilter::Reset(rotation);
-        m_SecondStage = rotation;
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "KalmanFilter::SetStrength", TLArg(strength, "Strength"));
+
+        FilterBase<Value>::SetStrength(strength);
+
+        // strength scales the assumed measurement noise, 0.5 equals the configured value
+        m_EffectiveNoise = m_MeasurementNoise * this->m_Strength / std::max(1.0f - this->m_Strength, 0.000001f);
+        DebugLog("%s kalman filter effective measurement noise: %f", this->m_Type, m_EffectiveNoise);
+
+        TraceLoggingWriteStop(local, "KalmanFilter::SetStrength", TLArg(m_EffectiveNoise, "EffectiveNoise"));
+
+        return this->m_Strength;
     }
 
-    void TripleSlerpFilter::ApplyFilter(XrQuaternionf& rotation)
+    template <typename Value>
+    void KalmanFilter<Value>::ApplyFilter(Value& value, const XrTime time)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local,
-                               "TripleSlerpFilter::ApplyFilter",
-                               TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                               TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"),
-                               TLArg(xr::ToString(this->m_SecondStage).c_str(), "m_SecondStage"),
-                               TLArg(xr::ToString(this->m_ThirdStage).c_str(), "m_ThirdStage"),
-                               TLArg(std::to_string(this->m_Strength).c_str(), "m_Strength"));
-
-        m_FirstStage = Quaternion::Slerp(rotation, m_FirstStage, m_Strength);
-        m_SecondStage = Quaternion::Slerp(m_FirstStage, m_SecondStage, m_Strength);
-        m_ThirdStage = Quaternion::Slerp(m_SecondStage, m_ThirdStage, m_Strength);
-        rotation = m_ThirdStage;
+                               "KalmanFilter::ApplyFilter",
+                               TLArg(time, "Time"),
+                               TLArg(xr::ToString(value).c_str(), "Value"),
+                               TLArg(xr::ToString(m_Estimate).c_str(), "Estimate"),
+                               TLArg(ToString(m_Velocity).c_str(), "Velocity"));
+
+        const XrTime previous = this->m_LastTime;
+        if (0 == previous)
+        {
+            Reset(value);
+            this->m_LastTime = time;
+            TraceLoggingWriteStop(local, "KalmanFilter::ApplyFilter", TLArg(true, "Initial"));
+            return;
+        }
+        if (time <= previous)
+        {
+            // out of order sample: use estimate at requested time without updating the filter state
+            value = Predict(static_cast<float>(time - previous) / 1000000000.0f);
+            TraceLoggingWriteStop(local, "KalmanFilter::ApplyFilter", TLArg(false, "InOrder"));
+            return;
+        }
+        this->m_LastTime = time;
+        const float interval = static_cast<float>(std::min(time - previous, this->maxInterval)) / 1000000000.0f;
+
+        // predict state and covariance to requested time
+        m_Estimate = Predict(interval);
+        auto& [location, mixed, velocity] = m_Covariance;
+        const float noise = m_ProcessNoise * interval;
+        location += interval * (2.0f * mixed + interval * velocity) + noise * interval * interval / 3.0f;
+        mixed += interval * velocity + noise * interval / 2.0f;
+        velocity += noise;
+
+        // correct with measurement
+        const float innovation = location + m_EffectiveNoise;
+        const float gain = location / innovation;
+        const float velocityGain = mixed / innovation;
+        Correct(value, gain, velocityGain);
+        velocity -= velocityGain * mixed;
+        mixed *= 1.0f - gain;
+        location *= 1.0f - gain;
+
+        value = m_Estimate;
 
         TraceLoggingWriteStop(local,
-                              "TripleSlerpFilter::ApplyFilter",
-                              TLArg(xr::ToString(rotation).c_str(), "rotation"),
-                              TLArg(xr::ToString(this->m_FirstStage).c_str(), "m_FirstStage"),
-                              TLArg(xr::ToString(this->m_SecondStage).c_str(), "m_SecondStage"),
-                              TLArg(xr::ToString(this->m_ThirdStage).c_str(), "m_ThirdStage"));
+                              "KalmanFilter::ApplyFilter",
+                              TLArg(xr::ToString(value).c_str(), "Value"),
+                              TLArg(ToString(m_Velocity).c_str(), "Velocity"),
+                              TLArg(gain, "Gain"),
+                              TLArg(velocityGain, "VelocityGain"));
     }
 
-    void TripleSlerpFilter::Reset(const XrQuaternionf& rotation)
+    template <typename Value>
+    void KalmanFilter<Value>::Reset(const Value& value)
     {
-        SingleSlerpFilter::Reset(rotation);
-        m_ThirdStage = rotation;
+        m_Estimate = value;
+        m_Velocity = DirectX::g_XMZero;
+        // velocity is unknown initially
+        m_Covariance[0] = m_EffectiveNoise;
+        m_Covariance[1] = 0.0f;
+        m_Covariance[2] = m_ProcessNoise;
+        this->m_LastTime = 0;
+    }
+
+    template <>
+    XrVector3f KalmanFilter<XrVector3f>::Predict(const float interval) const
+    {
+        XrVector3f result;
+        StoreXrVector3(
+            &result,
+            DirectX::XMVectorMultiplyAdd(m_Velocity, DirectX::XMVectorReplicate(interval), LoadXrVector3(m_Estimate)));
+        return result;
+    }
+
+    template <>
+    void KalmanFilter<XrVector3f>::Correct(const XrVector3f& measurement, const float gain, const float velocityGain)
+    {
+        const DirectX::XMVECTOR estimate = LoadXrVector3(m_Estimate);
+        const DirectX::XMVECTOR error = DirectX::XMVectorSubtract(LoadXrVector3(measurement), estimate);
+        StoreXrVector3(&m_Estimate, DirectX::XMVectorMultiplyAdd(error, DirectX::XMVectorReplicate(gain), estimate));
+        m_Velocity = DirectX::XMVectorMultiplyAdd(error, DirectX::XMVectorReplicate(velocityGain), m_Velocity);
+    }
+
+    // convert rotation vector (axis * angle) into quaternion
+    static DirectX::XMVECTOR XM_CALLCONV ToQuaternion(DirectX::FXMVECTOR rotation)
+    {
+        const float angle = DirectX::XMVectorGetX(DirectX::XMVector3Length(rotation));
+        return angle > 0.000001f ? DirectX::XMQuaternionRotationAxis(rotation, angle)
+                                 : DirectX::XMQuaternionIdentity();
+    }
+
+    // convert quaternion into rotation vector (axis * angle), using the shorter rotation
+    static DirectX::XMVECTOR XM_CALLCONV ToRotationVector(DirectX::FXMVECTOR quaternion)
+    {
+        DirectX::XMVECTOR axis;
+        float angle;
+        DirectX::XMQuaternionToAxisAngle(&axis, &angle, quaternion);
+        if (angle > floatPi)
+        {
+            angle -= 2.0f * floatPi;
+        }
+        return std::abs(angle) > 0.000001f ? DirectX::XMVectorScale(DirectX::XMVector3Normalize(axis), angle)
+                                           : DirectX::XMVectorZero();
+    }
+
+    template <>
+    XrQuaternionf KalmanFilter<XrQuaternionf>::Predict(const float interval) const
+    {
+        // angular velocity is stored in local space of the estimated orientation
+        XrQuaternionf result;
+        StoreXrQuaternion(&result,
+                          DirectX::XMQuaternionNormalize(
+                              DirectX::XMQuaternionMultiply(ToQuaternion(DirectX::XMVectorScale(m_Velocity, interval)),
+                                                            LoadXrQuaternion(m_Estimate))));
+        return result;
+    }
+
+    template <>
+    void KalmanFilter<XrQuaternionf>::Correct(const XrQuaternionf& measurement,
+                                              const float gain,
+                                              const float velocityGain)
+    {
+        const DirectX::XMVECTOR estimate = LoadXrQuaternion(m_Estimate);
+        const DirectX::XMVECTOR error = ToRotationVector(
+            DirectX::XMQuaternionMultiply(LoadXrQuaternion(measurement), DirectX::XMQuaternionInverse(estimate)));
+        StoreXrQuaternion(&m_Estimate,
+                          DirectX::XMQuaternionNormalize(DirectX::XMQuaternionMultiply(
+                              ToQuaternion(DirectX::XMVectorScale(error, gain)), estimate)));
+        m_Velocity = DirectX::XMVectorMultiplyAdd(error, DirectX::XMVectorReplicate(velocityGain), m_Velocity);
+    }
+
+    template class EmaFilter<1>;
+    template class EmaFilter<2>;
+    template class EmaFilter<3>;
+    template class SlerpFilter<1>;
+    template class SlerpFilter<2>;
+    template class SlerpFilter<3>;
+    template class OneEuroFilter<XrVector3f>;
+    template class OneEuroFilter<XrQuaternionf>;
+    template class KalmanFilter<XrVector3f>;
+    template class KalmanFilter<XrQuaternionf>;
+
+    void SampleSeqLock::Store(const utility::Dof& dof)
+    {
+        // only contended by readers that ran out of retries
+        Lock();
+        // odd sequence marks write in progress
+        const uint32_t sequence = m_Sequence.load(std::memory_order_relaxed);
+        m_Sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < m_Values.size(); i++)
+        {
+            m_Values[i].store(dof.data[i], std::memory_order_relaxed);
+        }
+        m_Sequence.store(sequence + 2, std::memory_order_release);
+        m_WriteLock.clear(std::memory_order_release);
+    }
+
+    void SampleSeqLock::Load(utility::Dof& dof)
+    {
+        m_Reads.fetch_add(1, std::memory_order_relaxed);
+        for (uint32_t retry = 0; retry < maxReadRetries; retry++)
+        {
+            const uint32_t before = m_Sequence.load(std::memory_order_acquire);
+            if (0 == (before & 1))
+            {
+                Copy(dof);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_Sequence.load(std::memory_order_relaxed) == before)
+                {
+                    return;
+                }
+            }
+            m_Retries.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+        }
+        // writer keeps interfering (or was preempted mid-write) -> read while holding the write lock
+        Lock();
+        Copy(dof);
+        m_WriteLock.clear(std::memory_order_release);
+        m_LockedReads.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void SampleSeqLock::Lock()
+    {
+        while (m_WriteLock.test_and_set(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void SampleSeqLock::Copy(utility::Dof& dof) const
+    {
+        for (size_t i = 0; i < m_Values.size(); i++)
+        {
+            dof.data[i] = m_Values[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t SampleSeqLock::GetReads() const
+    {
+        return m_Reads.load(std::memory_order_relaxed);
+    }
+
+    uint64_t SampleSeqLock::GetRetries() const
+    {
+        return m_Retries.load(std::memory_order_relaxed);
+    }
+
+    uint64_t SampleSeqLock::GetLockedReads() const
+    {
+        return m_LockedReads.load(std::memory_order_relaxed);
+    }
+
+    void StabilizerBase::LogStatistics() const
+    {
+        const uint64_t reads = m_Published.GetReads();
+        const uint64_t retries = m_Published.GetRetries();
+        const uint64_t lockedReads = m_Published.GetLockedReads();
+        Log("stabilizer sample handoff: %llu reads, %llu retries due to concurrent writes, %llu locked reads",
+            reads,
+            retries,
+            lockedReads);
+        TraceLoggingWrite(g_traceProvider,
+                          "StabilizerBase::LogStatistics",
+                          TLArg(reads, "Reads"),
+                          TLArg(retries, "Retries"),
+                          TLArg(lockedReads, "LockedReads"));
     }
 
     PassThroughStabilizer::PassThroughStabilizer(const std::vector<utility::DofValue>& relevantValues)
@@ -227,6 +617,7 @@ namespace filter
     {
         std::unique_lock lock(m_SampleMutex);
         m_CurrentSample = dof;
+        m_Published.Store(m_CurrentSample);
     }
 
     void PassThroughStabilizer::Read(utility::Dof& dof)
@@ -234,10 +625,11 @@ namespace filter
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "PassThroughStabilizer::Read");
 
-        std::unique_lock lock(m_SampleMutex);
+        Dof published;
+        m_Published.Load(published);
         for (const DofValue value : m_RelevantValues)
         {
-            dof.data[value] = m_CurrentSample.data[value];
+            dof.data[value] = published.data[value];
         }
 
         TraceLoggingWriteStop(local, "PassThroughStabilizer::Read", TLArg(xr::ToString(dof).c_str(), "Dof"));
@@ -263,10 +655,11 @@ namespace filter
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "LowPassStabilizer::Read", TLArg(xr::ToString(dof).c_str(), "DofIn"));
 
-        std::unique_lock lock(m_SampleMutex);
+        Dof published;
+        m_Published.Load(published);
         for (const DofValue value : m_RelevantValues)
         {
-            dof.data[value] = m_CurrentSample.data[value];
+            dof.data[value] = published.data[value];
         }
         TraceLoggingWriteStop(local, "LowPassStabilizer::Read", TLArg(xr::ToString(dof).c_str(), "DofOut"));
     }
@@ -308,6 +701,16 @@ namespace filter
         TraceLoggingWriteStop(local, "LowPassStabilizer::SetFrequencies");
     }
 
+    void LowPassStabilizer::SetCutoff(const DofValue value, const float frequency)
+    {
+        // dofs excluded by a factor of 0 remain unfiltered
+        std::unique_lock lock(m_SampleMutex);
+        if (!m_Disabled && m_Frequency.data[value] != -1.f)
+        {
+            m_Frequency.data[value] = frequency;
+        }
+    }
+
     bool LowPassStabilizer::Disabled(const utility::Dof& dof)
     {
         TraceLocalActivity(local);
@@ -319,6 +722,7 @@ namespace filter
             {
                 m_CurrentSample.data[value] = m_Blocking ? 0.f : dof.data[value];
             }
+            m_Published.Store(m_CurrentSample);
         }
         TraceLoggingWriteStop(local,
                               "EmaStabilizer::Insert",
@@ -374,6 +778,7 @@ namespace filter
                 m_CurrentSample.data[value] = m_Frequency.data[value] == 0.f ? 0.f : dof.data[value];
             }
             m_Initialized = true;
+            m_Published.Store(m_CurrentSample);
             TraceLoggingWriteStop(local, "EmaStabilizer::Insert", TLArg(true, "InitialSample"));
             return;
         }
@@ -398,10 +803,54 @@ namespace filter
                                     TLArg(factor, "Factor"),
                                     TLArg(this->m_CurrentSample.data[value], "Current_Sample"));
         }
+        m_Published.Store(m_CurrentSample);
+
         TraceLoggingWriteStop(local, "EmaStabilizer::Insert");
     }
 
-    void BiQuadStabilizer::SetStrength(float strength)
+    template <size_t Sections>
+    BiQuadStabilizer<Sections>::BiQuadStabilizer(const std::vector<utility::DofValue>& relevantValues)
+        : LowPassStabilizer(relevantValues)
+    {
+        float interval;
+        if (GetConfig()->GetFloat(Cfg::StabilizerInterval, interval) && interval > 0.f)
+        {
+            m_MeasuredInterval = interval / 1000.0;
+            m_SamplingFrequency = static_cast<float>(1.0 / m_MeasuredInterval);
+        }
+        DebugLog("stabilizer nominal sampling frequency: %.1f Hz", m_SamplingFrequency);
+        Log("stabilizer filter order: %u", static_cast<uint32_t>(2 * Sections));
+
+        auto SetNotch = [this](const Cfg key, const DofValue value) {
+            GetConfig()->GetFloat(key, m_NotchFrequency.data[value]);
+            m_NotchFrequency.data[value] = std::max(m_NotchFrequency.data[value], 0.f);
+        };
+        SetNotch(Cfg::StabilizerNotchSway, sway);
+        SetNotch(Cfg::StabilizerNotchSurge, surge);
+        SetNotch(Cfg::StabilizerNotchHeave, heave);
+        SetNotch(Cfg::StabilizerNotchYaw, yaw);
+        SetNotch(Cfg::StabilizerNotchRoll, roll);
+        SetNotch(Cfg::StabilizerNotchPitch, pitch);
+        if (GetConfig()->GetFloat(Cfg::StabilizerNotchBandwidth, m_NotchBandwidth))
+        {
+            m_NotchBandwidth = std::max(m_NotchBandwidth, 0.1f);
+        }
+        for (const DofValue value : m_RelevantValues)
+        {
+            if (m_NotchFrequency.data[value] > 0.f)
+            {
+                m_NotchActive = true;
+                Log("stabilizer notch(%u): %.2f Hz, bandwidth: %.2f Hz",
+                    value,
+                    m_NotchFrequency.data[value],
+                    m_NotchBandwidth);
+            }
+        }
+        SetCoefficients();
+    }
+
+    template <size_t Sections>
+    void BiQuadStabilizer<Sections>::SetStrength(float strength)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "BiQuadStabilizer::SetFrequency", TLArg(strength, "Strength"));
@@ -413,18 +862,21 @@ namespace filter
         TraceLoggingWriteStop(local, "BiQuadStabilizer::SetFrequency");
     }
 
-    void BiQuadStabilizer::SetStartTime(int64_t now)
+    template <size_t Sections>
+    void BiQuadStabilizer<Sections>::SetStartTime(int64_t now)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "BiQuadStabilizer::SetStartTime", TLArg(now, "Now"));
 
         std::unique_lock lock(m_SampleMutex);
+        m_LastSampleTime = now;
         ResetFilters();
 
         TraceLoggingWriteStop(local, "BiQuadStabilizer::SetStartTime");
     }
 
-    void BiQuadStabilizer::Insert(utility::Dof& dof, int64_t now)
+    template <size_t Sections>
+    void BiQuadStabilizer<Sections>::Insert(utility::Dof& dof, int64_t now)
     {
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local,
@@ -433,71 +885,442 @@ namespace filter
                                TLArg(now, "Now"));
 
         std::unique_lock lock(m_SampleMutex);
-        if (Disabled(dof))
+        UpdateSamplingFrequency(now);
+        // the notch keeps filtering with disabled low pass
+        if (!m_NotchActive && Disabled(dof))
         {
             TraceLoggingWriteStop(local, "BiQuadStabilizer::Insert", TLArg(true, "Disabled"));
             return;
         }
 
-        for (const DofValue value : m_RelevantValues)
+        alignas(32) Lanes values{};
+        std::copy(std::begin(dof.data), std::end(dof.data), values.begin());
+        if (!m_Initialized)
         {
-            if (m_Frequency.data[value] == -1.f)
+            // start in steady state instead of filtering the step from zero
+            InitState(values);
+            m_Initialized = true;
+        }
+        for (Section& section : m_Sections)
+        {
+            // fixed trip count over all lanes without branches, suitable for vectorization
+            for (size_t i = 0; i < lanes; i++)
             {
-                m_CurrentSample.data[value] = dof.data[value];
-                TraceLoggingWriteTagged(local,
-                                        "BiQuadStabilizer::Insert",
-                                        TLArg(static_cast<int>(value), "Value"),
-                                        TLArg(true, "Disabled"));
-                continue;
+                const double input = values[i];
+                const double output = section.b0[i] * input + section.b1[i] * section.x1[i] +
+                                      section.b2[i] * section.x2[i] - section.a1[i] * section.y1[i] -
+                                      section.a2[i] * section.y2[i];
+                section.x2[i] = section.x1[i];
+                section.x1[i] = input;
+                section.y2[i] = section.y1[i];
+                section.y1[i] = output;
+                values[i] = output;
             }
-            if (!m_Initialized)
+        }
+        for (const DofValue value : m_RelevantValues)
+        {
+            m_CurrentSample.data[value] = static_cast<float>(values[value]);
+        }
+        m_Published.Store(m_CurrentSample);
+
+        TraceLoggingWriteStop(local,
+                              "BiQuadStabilizer::Insert",
+                              TLArg(xr::ToString(m_CurrentSample).c_str(), "Current_Sample"));
+    }
+
+    template <size_t Sections>
+    void BiQuadStabilizer<Sections>::SetCutoff(const DofValue value, const float frequency)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local,
+                               "BiQuadStabilizer::SetCutoff",
+                               TLArg(static_cast<int>(value), "Value"),
+                               TLArg(frequency, "Frequency"));
+
+        // filter state is kept to avoid discontinuities, dofs excluded by a factor of 0 remain unfiltered
+        std::unique_lock lock(m_SampleMutex);
+        const bool apply = !m_Disabled && m_Frequency.data[value] != -1.f;
+        if (apply)
+        {
+            m_Frequency.data[value] = frequency;
+            SetCoefficients();
+        }
+
+        TraceLoggingWriteStop(local, "BiQuadStabilizer::SetCutoff", TLArg(apply, "Applied"));
+    }
+
+    template <size_t Sections>
+    void BiQuadStabilizer<Sections>::ResetFilters()
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "BiQuadStabilizer::ResetFilters");
+
+        for (Section& section : m_Sections)
+        {
+            section.x1.fill(0.0);
+            section.x2.fill(0.0);
+            section.y1.fill(0.0);
+            section.y2.fill(0.0);
+        }
+        SetCoefficients();
+        m_Initialized = false;
+
+        TraceLoggingWriteStop(local, "BiQuadStabilizer::ResetFilters");
+    }
+
+    template <size_t Sections>
+    void BiQuadStabilizer<Sections>::SetCoefficients()
+    {
+        SetNotchCoefficients();
+        for (size_t k = 0; k < Sections; k++)
+        {
+            Section& section = m_Sections[k + 1];
+
+            // pass through on all lanes not being filtered
+            section.b0.fill(1.0);
+            section.b1.fill(0.0);
+            section.b2.fill(0.0);
+            section.a1.fill(0.0);
+            section.a2.fill(0.0);
+
+            // quality factor of the k-th pole pair of a butterworth filter with order 2 * Sections
+            const double q = 1.0 / (2.0 * sin((2.0 * k + 1.0) * M_PI / (4.0 * Sections)));
+            for (const DofValue value : m_RelevantValues)
             {
-                // skip attack time
-                for (int i = 0; i < 1e5; i++)
+                const float frequency = m_Frequency.data[value];
+                if (m_Blocking)
                 {
-                    m_Filter[value]->Filter(dof.data[value]);
+                    section.b0[value] = 0.0;
+                    continue;
                 }
+                if (m_Disabled || frequency == -1.f)
+                {
+                    continue;
+                }
+                // keep cutoff below nyquist frequency
+                const double limited = std::min(static_cast<double>(frequency), 0.45 * m_SamplingFrequency);
+                const double a = tan(M_PI * limited / m_SamplingFrequency);
+                const double aSquare = a * a;
+                const double norm = 1.0 / (aSquare + a / q + 1.0);
+                section.b0[value] = aSquare * norm;
+                section.b1[value] = 2.0 * aSquare * norm;
+                section.b2[value] = aSquare * norm;
+                section.a1[value] = 2.0 * (aSquare - 1.0) * norm;
+                section.a2[value] = (aSquare - a / q + 1.0) * norm;
             }
-            m_CurrentSample.data[value] = m_Filter[value]->Filter(dof.data[value]);
-            TraceLoggingWriteTagged(local,
-                                    "BiQuadStabilizer::Insert",
-                                    TLArg(static_cast<int>(value), "Value"),
-                                    TLArg(this->m_CurrentSample.data[value], "Current_Sample"));
         }
-        m_Initialized = true;
+    }
+
+    template <size_t Sections>
+    void BiQuadStabilizer<Sections>::SetNotchCoefficients()
+    {
+        Section& section = m_Sections[0];
+        section.b0.fill(1.0);
+        section.b1.fill(0.0);
+        section.b2.fill(0.0);
+        section.a1.fill(0.0);
+        section.a2.fill(0.0);
+
+        for (const DofValue value : m_RelevantValues)
+        {
+            const float frequency = m_NotchFrequency.data[value];
+            if (frequency <= 0.f || frequency >= 0.45f * m_SamplingFrequency)
+            {
+                continue;
+            }
+            // band stop with unity gain outside of the stop band, quality factor from center frequency and width
+            const double omega = 2.0 * M_PI * frequency / m_SamplingFrequency;
+            const double alpha = sin(omega) * m_NotchBandwidth / (2.0 * frequency);
+            const double cosine = cos(omega);
+            const double norm = 1.0 / (1.0 + alpha);
+            section.b0[value] = norm;
+            section.b1[value] = -2.0 * cosine * norm;
+            section.b2[value] = norm;
+            section.a1[value] = -2.0 * cosine * norm;
+            section.a2[value] = (1.0 - alpha) * norm;
+        }
+    }
 
-        TraceLoggingWriteStop(local, "BiQuadStabilizer::Insert");
+    template <size_t Sections>
+    void BiQuadStabilizer<Sections>::InitState(const Lanes& input)
+    {
+        Lanes values = input;
+        for (Section& section : m_Sections)
+        {
+            for (size_t i = 0; i < lanes; i++)
+            {
+                // dc gain of the section, a cutoff frequency of zero blocks the input
+                const double denominator = 1.0 + section.a1[i] + section.a2[i];
+                const double gain =
+                    denominator > 1e-12 ? (section.b0[i] + section.b1[i] + section.b2[i]) / denominator : 0.0;
+                const double output = gain * values[i];
+                section.x1[i] = section.x2[i] = values[i];
+                section.y1[i] = section.y2[i] = output;
+                values[i] = output;
+            }
+        }
     }
 
-    void BiQuadStabilizer::ResetFilters()
+    template <size_t Sections>
+    void BiQuadStabilizer<Sections>::UpdateSamplingFrequency(const int64_t now)
     {
+        if (m_LastSampleTime <= 0 || now <= m_LastSampleTime)
+        {
+            m_LastSampleTime = now;
+            return;
+        }
+        // limit impact of single stalled sampling cycles
+        const double interval = std::min(static_cast<double>(now - std::exchange(m_LastSampleTime, now)) / 1e9,
+                                         4.0 / m_SamplingFrequency);
+        m_MeasuredInterval += (interval - m_MeasuredInterval) * intervalSmoothing;
+
+        const float measured = static_cast<float>(1.0 / m_MeasuredInterval);
+        if (std::abs(measured - m_SamplingFrequency) <= m_SamplingFrequency * maxDrift)
+        {
+            return;
+        }
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local, "BiQuadStabilizer::ResetFilters");
+        TraceLoggingWriteStart(local,
+                               "BiQuadStabilizer::UpdateSamplingFrequency",
+                               TLArg(m_SamplingFrequency, "Previous"),
+                               TLArg(measured, "Measured"));
+
+        DebugLog("stabilizer sampling frequency adjusted: %.1f -> %.1f Hz", m_SamplingFrequency, measured);
+        m_SamplingFrequency = measured;
+        SetCoefficients();
 
+        TraceLoggingWriteStop(local, "BiQuadStabilizer::UpdateSamplingFrequency");
+    }
+
+    template class BiQuadStabilizer<1>;
+    template class BiQuadStabilizer<2>;
+
+    CutoffAnalyzer::CutoffAnalyzer(const std::vector<utility::DofValue>& relevantValues)
+        : m_RelevantValues(relevantValues), m_Times(windowSize), m_Data(windowSize)
+    {
         for (const DofValue value : m_RelevantValues)
         {
-            m_Filter[value] = std::make_unique<BiQuadFilter>(BiQuadFilter(m_Frequency.data[value]));
+            m_Window[value].resize(windowSize);
+            m_Spectrum[value].resize(windowSize / 2);
         }
-        m_Initialized = false;
+        m_Pending.reserve(m_RelevantValues.size());
+        m_NoiseBand.reserve(windowSize / 2);
+        Log("stabilizer auto tuning is enabled, manually set strength is overridden by analysis results");
+    }
 
-        TraceLoggingWriteStop(local, "BiQuadStabilizer::ResetFilters");
+    bool CutoffAnalyzer::Add(const utility::Dof& dof, const int64_t now, DofValue& value, float& cutoff)
+    {
+        for (const DofValue relevant : m_RelevantValues)
+        {
+            // unwrap angles (in degrees) to avoid steps when crossing +/-180 degrees
+            float delta = dof.data[relevant] - m_Previous.data[relevant];
+            if (relevant >= yaw)
+            {
+                delta = std::fmod(delta + 540.0f, 360.0f) - 180.0f;
+            }
+            m_Unwrapped[relevant] = m_Started ? m_Unwrapped[relevant] + delta : dof.data[relevant];
+            m_Previous.data[relevant] = dof.data[relevant];
+            m_Accumulated[relevant] += m_Unwrapped[relevant];
+        }
+        m_Started = true;
+
+        // decimate by averaging
+        if (++m_AccumulatedCount == decimation)
+        {
+            for (const DofValue relevant : m_RelevantValues)
+            {
+                m_Window[relevant][m_Position] = m_Accumulated[relevant] / decimation;
+                m_Accumulated[relevant] = 0.0;
+            }
+            m_Times[m_Position] = now;
+            m_Position = (m_Position + 1) % windowSize;
+            m_Filled = std::min(m_Filled + 1, windowSize);
+            m_AccumulatedCount = 0;
+            if (windowSize == m_Filled && ++m_SinceAnalysis >= hopSize)
+            {
+                m_SinceAnalysis = 0;
+                m_Pending.assign(m_RelevantValues.begin(), m_RelevantValues.end());
+            }
+        }
+        if (m_Pending.empty())
+        {
+            return false;
+        }
+        value = m_Pending.back();
+        m_Pending.pop_back();
+        return Analyze(value, cutoff);
     }
 
-    BiQuadStabilizer::BiQuadFilter::BiQuadFilter(float frequency)
+    bool CutoffAnalyzer::Analyze(const DofValue value, float& cutoff)
     {
-        const double r = sin(M_PI_4);
-        const double a = tan(M_PI * frequency / m_SamplingFrequency);
-        const double aSquare = a * a;
-        const double s = (aSquare + 2.0 * a * r + 1.0);
-        m_A = aSquare / s;
-        m_D1 = 2.0 * (1.0 - aSquare) / s;
-        m_D2 = -(aSquare - 2.0 * a * r + 1.0) / s;
-        m_W0 = m_W1 = m_W2 = 0.0;
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "CutoffAnalyzer::Analyze", TLArg(static_cast<int>(value), "Value"));
+
+        // the ring buffer is full, so the oldest sample is located at the write position
+        const int64_t span = m_Times[(m_Position + windowSize - 1) % windowSize] - m_Times[m_Position];
+        if (span <= 0)
+        {
+            TraceLoggingWriteStop(local, "CutoffAnalyzer::Analyze", TLArg(false, "Success"));
+            return false;
+        }
+        const double samplingFrequency = static_cast<double>(windowSize - 1) * 1e9 / static_cast<double>(span);
+        const double resolution = samplingFrequency / windowSize;
+
+        // remove mean and linear trend, apply hann window
+        const std::vector<double>& window = m_Window[value];
+        constexpr double center = (windowSize - 1) / 2.0;
+        double mean{0.0}, slope{0.0}, squares{0.0};
+        for (size_t i = 0; i < windowSize; i++)
+        {
+            mean += window[(m_Position + i) % windowSize];
+        }
+        mean /= windowSize;
+        for (size_t i = 0; i < windowSize; i++)
+        {
+            const double x = static_cast<double>(i) - center;
+            slope += x * (window[(m_Position + i) % windowSize] - mean);
+            squares += x * x;
+        }
+        slope /= squares;
+        for (size_t i = 0; i < windowSize; i++)
+        {
+            const double detrended =
+                window[(m_Position + i) % windowSize] - mean - slope * (static_cast<double>(i) - center);
+            m_Data[i] = detrended * 0.5 * (1.0 - cos(2.0 * M_PI * static_cast<double>(i) / (windowSize - 1)));
+        }
+        Fft(m_Data);
+
+        // average power spectrum over consecutive analyses
+        std::vector<double>& spectrum = m_Spectrum[value];
+        if (!m_SpectrumValid[value])
+        {
+            m_SpectrumValid[value] = true;
+            for (size_t k = 0; k < windowSize / 2; k++)
+            {
+                spectrum[k] = std::norm(m_Data[k]);
+            }
+        }
+        else
+        {
+            for (size_t k = 0; k < windowSize / 2; k++)
+            {
+                spectrum[k] += (std::norm(m_Data[k]) - spectrum[k]) * spectrumSmoothing;
+            }
+        }
+
+        // noise floor is the median power within the noise band
+        std::vector<double>& noiseBand = m_NoiseBand;
+        noiseBand.clear();
+        const double noiseLimit = std::min(static_cast<double>(noiseBandEnd), 0.45 * samplingFrequency);
+        for (size_t k = 1; k < windowSize / 2; k++)
+        {
+            const double frequency = static_cast<double>(k) * resolution;
+            if (frequency >= noiseBandStart && frequency < noiseLimit)
+            {
+                noiseBand.push_back(spectrum[k]);
+            }
+        }
+        if (noiseBand.empty())
+        {
+            if (!m_NoiseBandMissing)
+            {
+                m_NoiseBandMissing = true;
+                Log("stabilizer auto tuning: decimated sampling rate of %.1f Hz doesn't cover the noise band "
+                    "(%.0f - %.0f Hz), cutoff frequencies are not adjusted",
+                    samplingFrequency,
+                    noiseBandStart,
+                    noiseBandEnd);
+            }
+            TraceLoggingWriteStop(local, "CutoffAnalyzer::Analyze", TLArg(false, "Success"));
+            return false;
+        }
+        const auto median = noiseBand.begin() + static_cast<ptrdiff_t>(noiseBand.size() / 2);
+        std::nth_element(noiseBand.begin(), median, noiseBand.end());
+        const double noiseFloor = *median;
+
+        // motion band contains the bulk of the power exceeding the noise floor
+        const size_t motionBins =
+            std::min(static_cast<size_t>(noiseBandStart / resolution), windowSize / 2);
+        double total{0.0};
+        for (size_t k = 1; k < motionBins; k++)
+        {
+            total += std::max(spectrum[k] - noiseThreshold * noiseFloor, 0.0);
+        }
+        if (total <= noiseFloor * static_cast<double>(motionBins))
+        {
+            // no motion distinguishable from noise (random peaks of a noise spectrum exceed the threshold only in a
+            // few bins), keep current setting
+            TraceLoggingWriteStop(local,
+                                  "CutoffAnalyzer::Analyze",
+                                  TLArg(false, "Success"),
+                                  TLArg(noiseFloor, "NoiseFloor"));
+            return false;
+        }
+        double cumulated{0.0};
+        size_t edge = 1;
+        for (; edge < motionBins; edge++)
+        {
+            cumulated += std::max(spectrum[edge] - noiseThreshold * noiseFloor, 0.0);
+            if (cumulated >= motionEnergy * total)
+            {
+                break;
+            }
+        }
+        const float bandEdge = static_cast<float>(static_cast<double>(edge) * resolution);
+        cutoff = std::clamp(bandEdge * margin, minCutoff, noiseBandStart);
+
+        if (std::abs(cutoff - m_LoggedCutoff.data[value]) > 0.1f * m_LoggedCutoff.data[value])
+        {
+            m_LoggedCutoff.data[value] = cutoff;
+            Log("stabilizer auto tuning(%u): motion band up to %.2f Hz, noise floor: %.3e, cutoff set to %.2f Hz",
+                value,
+                bandEdge,
+                noiseFloor,
+                cutoff);
+        }
+
+        TraceLoggingWriteStop(local,
+                              "CutoffAnalyzer::Analyze",
+                              TLArg(true, "Success"),
+                              TLArg(bandEdge, "BandEdge"),
+                              TLArg(noiseFloor, "NoiseFloor"),
+                              TLArg(cutoff, "Cutoff"));
+        return true;
     }
 
-    float BiQuadStabilizer::BiQuadFilter::Filter(const float value)
+    void CutoffAnalyzer::Fft(std::vector<std::complex<double>>& data)
     {
-        m_W0 = m_D1 * m_W1 + m_D2 * m_W2 + value;
-        return static_cast<float>(m_A * (std::exchange(m_W2, m_W1) + 2.0f * std::exchange(m_W1, m_W0) + m_W0));
+        // iterative radix-2 decimation in time, size has to be a power of two
+        const size_t size = data.size();
+        for (size_t i = 1, j = 0; i < size; i++)
+        {
+            size_t bit = size >> 1;
+            for (; j & bit; bit >>= 1)
+            {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j)
+            {
+                std::swap(data[i], data[j]);
+            }
+        }
+        for (size_t length = 2; length <= size; length <<= 1)
+        {
+            const double angle = -2.0 * M_PI / static_cast<double>(length);
+            const std::complex<double> step(cos(angle), sin(angle));
+            for (size_t start = 0; start < size; start += length)
+            {
+                std::complex<double> twiddle(1.0, 0.0);
+                for (size_t k = 0; k < length / 2; k++)
+                {
+                    const std::complex<double> even = data[start + k];
+                    const std::complex<double> odd = data[start + k + length / 2] * twiddle;
+                    data[start + k] = even + odd;
+                    data[start + k + length / 2] = even - odd;
+                    twiddle *= step;
+                }
+            }
+        }
     }
 } // namespace filter
\ No newline at end of file
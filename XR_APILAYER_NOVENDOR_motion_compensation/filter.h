@@ -10,105 +10,252 @@ namespace filter
     class FilterBase
     {
       public:
-        explicit FilterBase(const float strength, const std::string& type) : m_Type(type)
+        explicit FilterBase(const float strength, const char* type) : m_Type(type)
         {
             FilterBase<Value>::SetStrength(strength);
         }
-        virtual ~FilterBase(){};
-        virtual float SetStrength(const float strength)
+        float SetStrength(const float strength)
         {
             const float limitedStrength = std::min(1.0f, std::max(0.0f, strength));
-            openxr_api_layer::log::DebugLog("%s filter strength set: %f", m_Type.c_str(), limitedStrength);
+            openxr_api_layer::log::DebugLog("%s filter strength set: %f", m_Type, limitedStrength);
             m_Strength = limitedStrength;
             return m_Strength;
         }
-        void Filter(Value& value)
+
+        // scale strength with the time passed since the previous sample instead of applying it once per frame
+        void SetTimeBased(const bool timeBased)
         {
-            if (0.0f < m_Strength)
+            openxr_api_layer::log::Log("%s filter is %s", m_Type, timeBased ? "time based" : "frame based");
+            m_TimeBased = timeBased;
+            m_LastTime = 0;
+        }
+
+      protected:
+        // exponent to apply on the strength, time based filters yield the configured strength at reference rate
+        [[nodiscard]] float Exponent(const XrTime time)
+        {
+            if (!m_TimeBased)
+            {
+                return 1.0f;
+            }
+            const XrTime previous = m_LastTime;
+            if (time <= previous)
+            {
+                // out of order sample
+                return 1.0f;
+            }
+            m_LastTime = time;
+            if (0 == previous)
             {
-                ApplyFilter(value);
+                return 1.0f;
             }
+            return static_cast<float>(std::min(time - previous, maxInterval)) / static_cast<float>(referenceInterval);
         }
-        virtual void ApplyFilter(Value& value) = 0;
-        virtual void Reset(const Value& value) = 0;
 
-      protected:
+        static constexpr XrTime referenceInterval{1000000000 / 90};
+        static constexpr XrTime maxInterval{1000000000};
+
         float m_Strength;
-        std::string m_Type;
+        const char* m_Type;
+        bool m_TimeBased{false};
+        XrTime m_LastTime{0};
     };
 
-    // translational filters
-    class SingleEmaFilter : public FilterBase<XrVector3f>
+    // translational filter, cascading Order exponential moving average stages
+    template <size_t Order>
+    class EmaFilter : public FilterBase<XrVector3f>
     {
+        static_assert(1 <= Order && Order <= 3, "supported filter orders are 1 to 3");
+
       public:
-        explicit SingleEmaFilter(float strength);
-        float SetStrength(float strength) override;
-        void ApplyFilter(XrVector3f& location) override;
-        void Reset(const XrVector3f& location) override;
+        explicit EmaFilter(float strength);
+        float SetStrength(float strength);
+        void Filter(XrVector3f& location, const XrTime time)
+        {
+            if (0.0f < m_Strength)
+            {
+                ApplyFilter(location, time);
+            }
+        }
+        void Reset(const XrVector3f& location);
 
-      protected:
-        XrVector3f m_Alpha{1.0f - m_Strength, 1.0f - m_Strength, 1.0f - m_Strength};
-        XrVector3f m_OneMinusAlpha{m_Strength, m_Strength, m_Strength};
-        XrVector3f m_Ema{0, 0, 0};
-        [[nodiscard]] XrVector3f EmaFunction(XrVector3f current, XrVector3f stored) const;
       private:
+        void ApplyFilter(XrVector3f& location, XrTime time);
+        void SetAlpha(float exponent);
+        [[nodiscard]] DirectX::XMVECTOR XM_CALLCONV EmaFunction(DirectX::FXMVECTOR current,
+                                                                DirectX::FXMVECTOR stored) const;
+
+        // filter stages are kept in 4-wide simd registers, w component is unused
+        DirectX::XMVECTOR m_Alpha = DirectX::g_XMOne;
+        DirectX::XMVECTOR m_OneMinusAlpha = DirectX::g_XMZero;
+        std::array<DirectX::XMVECTOR, Order> m_Stages{};
         float m_VerticalFactor{1.f};
+        float m_VerticalStrength{0.f};
     };
 
-    class DoubleEmaFilter : public SingleEmaFilter
+    // rotational filter, cascading Order slerp stages
+    template <size_t Order>
+    class SlerpFilter : public FilterBase<XrQuaternionf>
     {
+        static_assert(1 <= Order && Order <= 3, "supported filter orders are 1 to 3");
+
       public:
-        explicit DoubleEmaFilter(const float strength) : SingleEmaFilter(strength){};
-        void ApplyFilter(XrVector3f& location) override;
-        void Reset(const XrVector3f& location) override;
+        explicit SlerpFilter(const float strength) : FilterBase(strength, "rotational")
+        {
+            m_Stages.fill(xr::math::Quaternion::Identity());
+        }
+        void Filter(XrQuaternionf& rotation, const XrTime time)
+        {
+            if (0.0f < m_Strength)
+            {
+                ApplyFilter(rotation, time);
+            }
+        }
+        void Reset(const XrQuaternionf& rotation);
 
-      protected:
-        XrVector3f m_EmaEma{0, 0, 0};
+      private:
+        void ApplyFilter(XrQuaternionf& rotation, XrTime time);
+
+        std::array<XrQuaternionf, Order> m_Stages{};
     };
 
-    class TripleEmaFilter : public DoubleEmaFilter
+    // speed adaptive low pass filter (one euro filter), the cutoff frequency rises with the rate of change
+    // minimum cutoff is derived from strength, beta determines the increase per unit of speed
+    template <typename Value>
+    class OneEuroFilter : public FilterBase<Value>
     {
       public:
-        explicit TripleEmaFilter(const float strength) : DoubleEmaFilter(strength){};
-        void ApplyFilter(XrVector3f& location) override;
-        void Reset(const XrVector3f& location) override;
+        explicit OneEuroFilter(float strength);
+        float SetStrength(float strength);
+        void Filter(Value& value, const XrTime time)
+        {
+            if (0.0f < this->m_Strength)
+            {
+                ApplyFilter(value, time);
+            }
+        }
+        void Reset(const Value& value);
 
-      protected:
-        XrVector3f m_EmaEmaEma{0, 0, 0};
+      private:
+        void ApplyFilter(Value& value, XrTime time);
+        [[nodiscard]] static float Alpha(float cutoff, float interval);
+        [[nodiscard]] float Distance(const Value& value) const;
+        [[nodiscard]] Value Smooth(const Value& value, float alpha) const;
+
+        static constexpr float derivativeCutoff{1.0f};
+
+        float m_MinCutoff{0.0f};
+        float m_Beta{0.0f};
+        float m_Speed{0.0f};
+        Value m_Filtered{};
     };
 
-    // rotational filters
-    class SingleSlerpFilter : public FilterBase<XrQuaternionf>
+    // constant velocity kalman filter, estimating location (or orientation) and velocity
+    // all axes share one covariance matrix because they use the same noise parameters and are updated together
+    // rotation uses the rotation vector between estimated and measured orientation as error state
+    template <typename Value>
+    class KalmanFilter : public FilterBase<Value>
     {
       public:
-        explicit SingleSlerpFilter(const float strength) : FilterBase(strength, "rotational"){};
-        void ApplyFilter(XrQuaternionf& rotation) override;
-        void Reset(const XrQuaternionf& rotation) override;
+        explicit KalmanFilter(float strength);
+        float SetStrength(float strength);
+        void Filter(Value& value, const XrTime time)
+        {
+            if (0.0f < this->m_Strength)
+            {
+                ApplyFilter(value, time);
+            }
+        }
+        void Reset(const Value& value);
 
-      protected:
-        XrQuaternionf m_FirstStage = xr::math::Quaternion::Identity();
+      private:
+        void ApplyFilter(Value& value, XrTime time);
+        [[nodiscard]] Value Predict(float interval) const;
+        void Correct(const Value& measurement, float gain, float velocityGain);
+
+        float m_ProcessNoise{1.0f};
+        float m_MeasurementNoise{0.000001f};
+        float m_EffectiveNoise{0.000001f};
+        // upper triangle of symmetric covariance matrix: location, location/velocity, velocity
+        float m_Covariance[3]{};
+        Value m_Estimate{};
+        DirectX::XMVECTOR m_Velocity = DirectX::g_XMZero;
     };
 
-    class DoubleSlerpFilter : public SingleSlerpFilter
+    // placeholder until the configured filter is created, leaves values untouched and doesn't access the config
+    template <typename Value>
+    class NoFilter
     {
       public:
-        explicit DoubleSlerpFilter(const float strength) : SingleSlerpFilter(strength){};
-        void ApplyFilter(XrQuaternionf& rotation) override;
-        void Reset(const XrQuaternionf& rotation) override;
-
-      protected:
-        XrQuaternionf m_SecondStage = xr::math::Quaternion::Identity();
+        float SetStrength(const float strength)
+        {
+            return std::min(1.0f, std::max(0.0f, strength));
+        }
+        void SetTimeBased(bool)
+        {}
+        void Filter(Value&, XrTime)
+        {}
+        void Reset(const Value&)
+        {}
     };
 
-    class TripleSlerpFilter : public DoubleSlerpFilter
+    // filters are held by value, the order (or type) is selected on configuration
+    typedef std::variant<NoFilter<XrVector3f>,
+                         EmaFilter<1>,
+                         EmaFilter<2>,
+                         EmaFilter<3>,
+                         OneEuroFilter<XrVector3f>,
+                         KalmanFilter<XrVector3f>>
+        TransFilter;
+    typedef std::variant<NoFilter<XrQuaternionf>,
+                         SlerpFilter<1>,
+                         SlerpFilter<2>,
+                         SlerpFilter<3>,
+                         OneEuroFilter<XrQuaternionf>,
+                         KalmanFilter<XrQuaternionf>>
+        RotFilter;
+
+    // (re)construct filter of given order in place, without heap allocation
+    template <template <size_t> typename Filter, typename Variant>
+    void SetOrder(Variant& filter, const int order, const float strength)
+    {
+        switch (order)
+        {
+        case 1:
+            filter.template emplace<Filter<1>>(strength);
+            break;
+        case 2:
+            filter.template emplace<Filter<2>>(strength);
+            break;
+        default:
+            filter.template emplace<Filter<3>>(strength);
+            break;
+        }
+    }
+
+    // handoff of the latest sample from sampler thread to frame thread(s) without locking (seqlock)
+    // readers retry while a write is in progress and only fall back to locking the writer out after repeated failures
+    class SampleSeqLock
     {
       public:
-        explicit TripleSlerpFilter(const float strength) : DoubleSlerpFilter(strength){};
-        void ApplyFilter(XrQuaternionf& rotation) override;
-        void Reset(const XrQuaternionf& rotation) override;
+        void Store(const utility::Dof& dof);
+        void Load(utility::Dof& dof);
+        [[nodiscard]] uint64_t GetReads() const;
+        [[nodiscard]] uint64_t GetRetries() const;
+        [[nodiscard]] uint64_t GetLockedReads() const;
 
-      protected:
-        XrQuaternionf m_ThirdStage = xr::math::Quaternion::Identity();
+      private:
+        static constexpr uint32_t maxReadRetries{1000};
+
+        void Lock();
+        void Copy(utility::Dof& dof) const;
+
+        std::atomic<uint32_t> m_Sequence{0};
+        std::array<std::atomic<float>, 6> m_Values{};
+        std::atomic_flag m_WriteLock{};
+        std::atomic<uint64_t> m_Reads{0};
+        std::atomic<uint64_t> m_Retries{0};
+        std::atomic<uint64_t> m_LockedReads{0};
     };
 
     class StabilizerBase
@@ -119,15 +266,21 @@ namespace filter
         virtual void SetStartTime(int64_t now) = 0;
         virtual void Insert(utility::Dof& sample, int64_t now) = 0;
         virtual void Read(utility::Dof& dof) = 0;
+        // override cutoff frequency of a single dof, e.g. determined by spectral analysis
+        virtual void SetCutoff(utility::DofValue, float)
+        {}
+        void LogStatistics() const;
 
       protected:
+        // guards filter state against configuration changes, not taken by readers
         std::mutex m_SampleMutex;
+        SampleSeqLock m_Published;
     };
 
     class PassThroughStabilizer : public StabilizerBase
     {
       public:
-        explicit PassThroughStabilizer(const std::vector<utility::DofValue>& relevantValues);;
+        explicit PassThroughStabilizer(const std::vector<utility::DofValue>& relevantValues);
         void SetStrength(float strength) override{};
         void SetStartTime(int64_t now) override{};
         void Insert(utility::Dof& dof, int64_t now) override;
@@ -144,6 +297,7 @@ namespace filter
       public:
         explicit LowPassStabilizer(const std::vector<utility::DofValue>& relevantValues);
         void Read(utility::Dof& dof) override;
+        void SetCutoff(utility::DofValue value, float frequency) override;
 
       protected:
         void SetFrequencies(float strength);
@@ -151,8 +305,6 @@ namespace filter
 
         bool m_Initialized{false};
         utility::Dof m_Frequency{};
-
-      private:
         bool m_Disabled{false}, m_Blocking{false};
     };
 
@@ -169,35 +321,99 @@ namespace filter
         int64_t m_LastSampleTime{};
     };
 
+    // butterworth low pass of order 2 * Sections, cascading second order sections (biquads)
+    // an optional notch (band stop) section in front of the low pass removes narrow band disturbances, like rig
+    // resonance, and remains active with the low pass disabled (strength = 0)
+    // coefficients and state of all dofs are kept as structure of arrays and processed in a single pass,
+    // lanes of irrelevant dofs are configured to pass their input through
+    template <size_t Sections>
     class BiQuadStabilizer : public LowPassStabilizer
     {
+        static_assert(1 <= Sections && Sections <= 2, "supported filter orders are 2 and 4");
+
       public:
-        explicit BiQuadStabilizer(const std::vector<utility::DofValue>& relevantValues)
-            : LowPassStabilizer(relevantValues){};
+        explicit BiQuadStabilizer(const std::vector<utility::DofValue>& relevantValues);
         void SetStrength(float strength) override;
         void SetStartTime(int64_t now) override;
         void Insert(utility::Dof& dof, int64_t now) override;
+        void SetCutoff(utility::DofValue value, float frequency) override;
 
       private:
-        void ResetFilters();
+        static constexpr size_t lanes{8};
+        typedef std::array<double, lanes> Lanes;
 
-        class BiQuadFilter
+        // direct form I, the state consists of past inputs and outputs only and remains valid when coefficients are
+        // recalculated, so a change of cutoff or sampling frequency doesn't disturb a constant input
+        struct Section
         {
-          public:
-            BiQuadFilter(float frequency);
-            float Filter(float value);
-
-          private:
-            float m_SamplingFrequency{600.f};
-
-            double m_A;
-            double m_D1;
-            double m_D2;
-            double m_W0;
-            double m_W1;
-            double m_W2;
+            alignas(32) Lanes b0{}, b1{}, b2{}, a1{}, a2{}, x1{}, x2{}, y1{}, y2{};
         };
 
-        std::unique_ptr<BiQuadFilter> m_Filter[6]{};
+        void ResetFilters();
+        void SetCoefficients();
+        void SetNotchCoefficients();
+        void InitState(const Lanes& input);
+        void UpdateSamplingFrequency(int64_t now);
+
+        // coefficients are recomputed when the measured sampling frequency drifts away from the one in use
+        static constexpr double intervalSmoothing{0.01};
+        static constexpr float maxDrift{0.01f};
+
+        float m_SamplingFrequency{1000.f};
+        double m_MeasuredInterval{0.001};
+        int64_t m_LastSampleTime{0};
+
+        // center frequency per dof (0 = no notch) and width of the stop band, in Hz
+        utility::Dof m_NotchFrequency{};
+        float m_NotchBandwidth{2.f};
+        bool m_NotchActive{false};
+
+        // notch section first, followed by the low pass sections
+        std::array<Section, Sections + 1> m_Sections{};
+    };
+
+    // spectral analysis of the sampled input, estimating per dof cutoff frequencies for the stabilizer
+    // the cutoff is placed just above the band containing the motion and below the broadband noise
+    // samples are decimated before analysis and only one dof is analyzed per call to bound the cost per cycle
+    class CutoffAnalyzer
+    {
+      public:
+        explicit CutoffAnalyzer(const std::vector<utility::DofValue>& relevantValues);
+        // returns true if an analysis has been completed with this sample
+        bool Add(const utility::Dof& dof, int64_t now, utility::DofValue& value, float& cutoff);
+
+      private:
+        [[nodiscard]] bool Analyze(utility::DofValue value, float& cutoff);
+        static void Fft(std::vector<std::complex<double>>& data);
+
+        static constexpr size_t decimation{4};
+        static constexpr size_t windowSize{1024};
+        static constexpr size_t hopSize{windowSize / 2};
+        static constexpr double spectrumSmoothing{0.3};
+        static constexpr float noiseBandStart{20.f}, noiseBandEnd{50.f};
+        static constexpr double noiseThreshold{2.0};
+        static constexpr double motionEnergy{0.98};
+        static constexpr float margin{1.5f}, minCutoff{0.5f};
+
+        std::vector<utility::DofValue> m_RelevantValues;
+        utility::Dof m_Previous{};
+        std::array<double, 6> m_Unwrapped{}, m_Accumulated{};
+        size_t m_AccumulatedCount{0};
+        bool m_Started{false};
+
+        // ring of decimated samples per dof and their sampling times
+        std::array<std::vector<double>, 6> m_Window{};
+        std::vector<int64_t> m_Times;
+        size_t m_Position{0}, m_Filled{0}, m_SinceAnalysis{0};
+
+        std::array<std::vector<double>, 6> m_Spectrum{};
+        std::array<bool, 6> m_SpectrumValid{};
+        utility::Dof m_LoggedCutoff{};
+        bool m_NoiseBandMissing{false};
+        std::vector<utility::DofValue> m_Pending;
+
+        // working memory of the analysis, allocated once to keep the sampling thread free of allocations
+        std::vector<std::complex<double>> m_Data;
+        std::vector<double> m_NoiseBand;
     };
 } // namespace filter
\ No newline at end of file
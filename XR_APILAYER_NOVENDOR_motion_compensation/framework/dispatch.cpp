@@ -74,6 +74,12 @@ namespace openxr_api_layer {
                 XR_HTCX_VIVE_TRACKER_INTERACTION_EXTENSION_NAME,
                 type.c_str());
         }
+
+        // request time conversion for aligning sampled motion data with display time
+        if (GetConfig()->IsVirtualTracker())
+        {
+            implicitExtensions.push_back(XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME);
+        }
  
         // Only request implicit extensions that are supported.
         //
@@ -166,6 +172,11 @@ namespace openxr_api_layer {
             }
         }
         for (const auto& ext : filteredImplicitExtensions) {
+            if (std::find(newEnabledExtensionNames.cbegin(), newEnabledExtensionNames.cend(), ext) !=
+                newEnabledExtensionNames.cend()) {
+                // already requested by the application
+                continue;
+            }
             Log(fmt::format("Requesting extension: {}", ext));
             newEnabledExtensionNames.push_back(ext.c_str());
         }
@@ -0,0 +1,13 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// globals defined by the layer entry point (framework/entry.cpp) or by the portable build (portable/platform.cpp)
+namespace openxr_api_layer
+{
+    // The handle of the dll
+    extern HMODULE dllModule;
+
+    // The path that is writable (eg: to store logs).
+    extern std::filesystem::path localAppData;
+} // namespace openxr_api_layer
@@ -441,8 +441,7 @@ namespace input
             Log("%s is used for reconstruction of eye positions", m_Layer->m_UseEyeCache ? "caching" : "calculation");
             GetConfig()->GetBool(Cfg::LegacyMode, m_Layer->m_LegacyMode);
             Log("legacy mode is %s", m_Layer->m_LegacyMode ? "activated" : "off");
-            m_Layer->m_AutoActivator =
-                std::make_unique<utility::AutoActivator>(utility::AutoActivator(m_Layer->m_Input));
+            m_Layer->m_AutoActivator = std::make_unique<AutoActivator>(AutoActivator(m_Layer->m_Input));
             m_Layer->m_HmdModifier = std::make_unique<modifier::HmdModifier>();
             m_Layer->m_VirtualTrackerUsed = GetConfig()->IsVirtualTracker();
             m_Layer->m_Tracker = tracker::GetTracker();
@@ -505,4 +504,47 @@ namespace input
         return path;
     }
 
+    AutoActivator::AutoActivator(const std::shared_ptr<InputHandler>& input)
+    {
+        m_Input = input;
+        GetConfig()->GetBool(Cfg::AutoActive, m_Activate);
+        GetConfig()->GetInt(Cfg::AutoActiveDelay, m_SecondsLeft);
+        GetConfig()->GetBool(Cfg::AutoActiveCountdown, m_Countdown);
+
+        Log("auto activation %s, delay: %d seconds, countdown %s",
+            m_Activate ? "on" : "off",
+            m_SecondsLeft,
+            m_Countdown ? "on" : "off");
+    }
+    void AutoActivator::ActivateIfNecessary(const XrTime time)
+    {
+        if (m_Activate)
+        {
+            TraceLocalActivity(local);
+            TraceLoggingWriteStart(local, "AutoActivator::ActivateIfNecessary", TLArg(time, "Time"));
+
+            if (m_SecondsLeft <= 0)
+            {
+                m_Input->ToggleActive(time);
+                m_Activate = false;
+                TraceLoggingWriteStop(local,
+                                      "AutoActivator::ActivateIfNecessary",
+                                      TLArg(m_SecondsLeft, "No_Seconds_Left"));
+                return;
+            }
+            if (0 == m_ActivationTime)
+            {
+                m_ActivationTime = time + ++m_SecondsLeft * 1000000000ll;
+            }
+            const int currentlyLeft = static_cast<int>((m_ActivationTime - time) / 1000000000ll);
+
+            if (m_Countdown && currentlyLeft < m_SecondsLeft)
+            {
+                AudioOut::CountDown(currentlyLeft);
+            }
+            m_SecondsLeft = currentlyLeft;
+
+            TraceLoggingWriteStop(local, "AutoActivator::ActivateIfNecessary", TLArg(m_SecondsLeft, "Seconds_Left"));
+        }
+    }
 } // namespace input
\ No newline at end of file
@@ -75,6 +75,20 @@ namespace input
         KeyboardInput m_Input;
     };
 
+    class AutoActivator
+    {
+      public:
+        explicit AutoActivator(const std::shared_ptr<InputHandler>& input);
+        void ActivateIfNecessary(XrTime time);
+
+      private:
+        std::shared_ptr<InputHandler> m_Input;
+        bool m_Activate{false};
+        bool m_Countdown{false};
+        int m_SecondsLeft{0};
+        XrTime m_ActivationTime{0};
+    };
+
     class ButtonPath
     {
       public:
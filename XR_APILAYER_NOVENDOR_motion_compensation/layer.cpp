@@ -167,7 +167,7 @@ namespace openxr_api_layer
         Log("graphical overlay is %s", overlayEnabled ? "enabled" : "disabled in config file");
 
         // initialize auto activator
-        m_AutoActivator = std::make_unique<utility::AutoActivator>(utility::AutoActivator(m_Input));
+        m_AutoActivator = std::make_unique<input::AutoActivator>(input::AutoActivator(m_Input));
 
         m_VirtualTrackerUsed = GetConfig()->IsVirtualTracker();
         if (m_PhysicalEnabled)
@@ -195,6 +195,16 @@ namespace openxr_api_layer
             }
         }
 
+        // align sampled motion data of virtual trackers with the requested display time
+        if (m_VirtualTrackerUsed)
+        {
+            utility::GetTimeConverter()->Init(
+                GetXrInstance(),
+                IsExtensionGranted(XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME)
+                    ? m_xrGetInstanceProcAddr
+                    : nullptr);
+        }
+
         // initialize tracker
         if (!m_Tracker->Init())
         {
@@ -226,7 +236,33 @@ namespace openxr_api_layer
         m_DeltaCache.SetTolerance(toleranceTime);
         m_EyeCache.SetTolerance(toleranceTime);
 
-        
+        bool useRingBuffer{false};
+        GetConfig()->GetBool(Cfg::CacheRingBuffer, useRingBuffer);
+        m_DeltaCache.UseRingBuffer(useRingBuffer);
+        m_EyeCache.UseRingBuffer(useRingBuffer);
+
+        bool interpolate{false};
+        GetConfig()->GetBool(Cfg::CacheInterpolation, interpolate);
+        m_DeltaCache.UseInterpolation(interpolate);
+        m_EyeCache.UseInterpolation(interpolate);
+
+        float extrapolationLimit{0.f};
+        GetConfig()->GetFloat(Cfg::CacheExtrapolation, extrapolationLimit);
+        const auto extrapolationTime = static_cast<XrTime>(extrapolationLimit * 1000000.0);
+        m_DeltaCache.SetExtrapolationLimit(extrapolationTime);
+        m_EyeCache.SetExtrapolationLimit(extrapolationTime);
+
+        if (float statsInterval; GetConfig()->GetFloat(Cfg::CacheStatistics, statsInterval) && statsInterval > 0.f)
+        {
+            m_CacheStatsInterval = static_cast<XrTime>(statsInterval * 1000000000.0);
+            Log("cache statistics are logged every %.3f s", statsInterval);
+        }
+
+        if (float timingInterval; GetConfig()->GetFloat(Cfg::PipelineTiming, timingInterval))
+        {
+            utility::GetPipelineTimer()->SetInterval(static_cast<XrTime>(timingInterval * 1000000000.0));
+        }
+
         // initialize keyboard input handler
         if (!m_Input->Init())
         {
@@ -1161,10 +1197,10 @@ namespace openxr_api_layer
         std::unique_lock lock(m_FrameLock);
 
         // store eye poses to avoid recalculation in xrEndFrame
-        std::vector<XrPosef> originalEyePoses{};
-        for (uint32_t i = 0; i < *viewCountOutput; i++)
+        utility::EyePoses originalEyePoses{};
+        for (uint32_t i = 0; i < std::min(*viewCountOutput, utility::maxViews); i++)
         {
-            originalEyePoses.push_back(views[i].pose);
+            originalEyePoses[i] = views[i].pose;
         }
         // assumption: the first xrLocateView call within a frame is the one used for rendering
         m_EyeCache.AddSample(displayTime, originalEyePoses, false);
@@ -1217,34 +1253,39 @@ namespace openxr_api_layer
                     if (m_ModifierActive && m_EyeToHmd && 0 < *viewCountOutput)
                     {
                         // apply hmd pose modifier on delta
+                        utility::PipelineTimer::Scope timing(utility::PipelineTimer::HmdModifier);
                         const XrPosef hmdPoseStage =
                             Pose::Multiply(Pose::Multiply(*m_EyeToHmd, views[0].pose), stageToRef);
                         m_HmdModifier->Apply(trackerDelta, hmdPoseStage);
                     }
-                    trackerDelta = Pose::Multiply(Pose::Multiply(stageToRef, trackerDelta), refToStage);
-                    for (uint32_t i = 0; i < *viewCountOutput; i++)
                     {
-                        DebugLog("xrLocateView(%u): eye (%u) original pose = %s",
-                                 displayTime,
-                                 i,
-                                 xr::ToString(views[i].pose).c_str());
-                        TraceLoggingWriteTagged(local,
-                                                "OpenXrLayer::xrLocateViews",
-                                                TLArg(i, "Index"),
-                                                TLArg(xr::ToString(views[i].fov).c_str(), "Fov"),
-                                                TLArg(xr::ToString(views[i].pose).c_str(), "OriginalViewPose"));
-
-                        // apply manipulation
-                        views[i].pose = xr::Normalize(Pose::Multiply(views[i].pose, trackerDelta));
-
-                        DebugLog("xrLocateView(%u): eye (%u) compensated pose = %s",
-                                 displayTime,
-                                 i,
-                                 xr::ToString(views[i].pose).c_str());
-                        TraceLoggingWriteTagged(local,
-                                                "OpenXrLayer::xrLocateViews",
-                                                TLArg(i, "Index"),
-                                                TLArg(xr::ToString(views[i].pose).c_str(), "CompensatedViewPose"));
+                        // compensate view poses
+                        utility::PipelineTimer::Scope timing(utility::PipelineTimer::ViewPoses);
+                        trackerDelta = Pose::Multiply(Pose::Multiply(stageToRef, trackerDelta), refToStage);
+                        for (uint32_t i = 0; i < *viewCountOutput; i++)
+                        {
+                            DebugLog("xrLocateView(%u): eye (%u) original pose = %s",
+                                     displayTime,
+                                     i,
+                                     xr::ToString(views[i].pose).c_str());
+                            TraceLoggingWriteTagged(local,
+                                                    "OpenXrLayer::xrLocateViews",
+                                                    TLArg(i, "Index"),
+                                                    TLArg(xr::ToString(views[i].fov).c_str(), "Fov"),
+                                                    TLArg(xr::ToString(views[i].pose).c_str(), "OriginalViewPose"));
+
+                            // apply manipulation
+                            views[i].pose = xr::Normalize(Pose::Multiply(views[i].pose, trackerDelta));
+
+                            DebugLog("xrLocateView(%u): eye (%u) compensated pose = %s",
+                                     displayTime,
+                                     i,
+                                     xr::ToString(views[i].pose).c_str());
+                            TraceLoggingWriteTagged(local,
+                                                    "OpenXrLayer::xrLocateViews",
+                                                    TLArg(i, "Index"),
+                                                    TLArg(xr::ToString(views[i].pose).c_str(), "CompensatedViewPose"));
+                        }
                     }
                 }
             }
@@ -1398,6 +1439,11 @@ namespace openxr_api_layer
         TraceLoggingWriteStart(local, "OpenXrLayer::xrWaitFrame", TLPArg(session, "Session"));
 
         const XrResult result = OpenXrApi::xrWaitFrame(session, frameWaitInfo, frameState);
+        if (XR_SUCCEEDED(result) && frameState->predictedDisplayPeriod > 0)
+        {
+            m_DeltaCache.SetFramePeriod(frameState->predictedDisplayPeriod);
+            m_EyeCache.SetFramePeriod(frameState->predictedDisplayPeriod);
+        }
 
         DebugLog("xrWaitFrame predicted time: %u, predicted period: %d",
                  frameState->predictedDisplayTime,
@@ -1485,15 +1531,31 @@ namespace openxr_api_layer
 
         XrPosef delta{Pose::Identity()};
         XrPosef deltaInverse{Pose::Identity()};
-        std::vector<XrPosef> cachedEyePoses;
+        utility::EyePoses cachedEyePoses{};
         if (m_Activated)
         {
            delta = m_DeltaCache.GetSample(time);
            deltaInverse = Pose::Invert(delta);
            m_DeltaCache.CleanUp(time);
-           cachedEyePoses =
-               m_UseEyeCache ? m_EyeCache.GetSample(time) : std::vector<XrPosef>();
+           if (m_UseEyeCache)
+           {
+               cachedEyePoses = m_EyeCache.GetSample(time);
+           }
            m_EyeCache.CleanUp(time);
+
+           if (m_CacheStatsInterval > 0 && time - m_CacheStatsTime >= m_CacheStatsInterval)
+           {
+               if (m_CacheStatsTime > 0)
+               {
+                   m_DeltaCache.LogStatistics();
+                   if (m_UseEyeCache)
+                   {
+                       m_EyeCache.LogStatistics();
+                   }
+               }
+               m_CacheStatsTime = time;
+           }
+           utility::GetPipelineTimer()->EndFrame(time);
         }
 
         if (m_Overlay)
@@ -1582,8 +1644,9 @@ namespace openxr_api_layer
                         TLArg(xr::ToString((*projectionViews)[j].fov).c_str(), "Fov"));
 
                     XrPosef revertedEyePose =
-                        m_UseEyeCache ? cachedEyePoses[j]
-                                      : xr::Normalize(Pose::Multiply((*projectionViews)[j].pose, deltaInverse));
+                        m_UseEyeCache && j < utility::maxViews
+                            ? cachedEyePoses[j]
+                            : xr::Normalize(Pose::Multiply((*projectionViews)[j].pose, deltaInverse));
 
                     (*projectionViews)[j].pose = revertedEyePose;
                     DebugLog("xrEndFrame: reverted view(%u) pose = %s", j, xr::ToString(revertedEyePose).c_str());
@@ -36,12 +36,8 @@ namespace openxr_api_layer
     const std::vector<std::string> blockedExtensions = {};
     inline std::vector<std::string> implicitExtensions = {};
 
-    // The handle of the dll
-    extern HMODULE dllModule;
-
     // The path where the DLL is loaded from (eg: to load data files).
     extern std::filesystem::path dllHome;
-    extern std::filesystem::path localAppData;
 
     const std::string LayerPrettyName = "OpenXR-MotionCompensation";
     const std::string LayerName = "XR_APILAYER_NOVENDOR_motion_compensation";
@@ -156,6 +152,8 @@ namespace openxr_api_layer
         bool m_RecorderActive{false};
         bool m_VarjoPollWorkaround{false};
         XrTime m_LastFrameTime{0};
+        XrTime m_CacheStatsInterval{0};
+        XrTime m_CacheStatsTime{0};
         XrTime m_UpdateRefSpaceTime{0};
         std::set<XrSpace> m_StaticRefSpaces{};
         std::map<XrSpace, std::pair<XrPosef, XrPosef>> m_RefToStageMap{};
@@ -170,16 +168,16 @@ namespace openxr_api_layer
         tracker::ViveTrackerInfo m_ViveTracker;
         input::ButtonPath m_ButtonPath;
         utility::Cache<XrPosef> m_DeltaCache{"delta", xr::math::Pose::Identity()};
-        utility::Cache<std::vector<XrPosef>> m_EyeCache{"eyes",
-                                                        std::vector<XrPosef>{xr::math::Pose::Identity(),
-                                                                             xr::math::Pose::Identity(),
-                                                                             xr::math::Pose::Identity(),
-                                                                             xr::math::Pose::Identity()}};
+        utility::Cache<utility::EyePoses> m_EyeCache{"eyes",
+                                                     utility::EyePoses{xr::math::Pose::Identity(),
+                                                                       xr::math::Pose::Identity(),
+                                                                       xr::math::Pose::Identity(),
+                                                                       xr::math::Pose::Identity()}};
         std::mutex m_FrameLock;
         std::unique_ptr<tracker::TrackerBase> m_Tracker{};
         std::unique_ptr<graphics::Overlay> m_Overlay{};
         std::shared_ptr<input::InputHandler> m_Input{};
-        std::unique_ptr<utility::AutoActivator> m_AutoActivator{};
+        std::unique_ptr<input::AutoActivator> m_AutoActivator{};
         std::unique_ptr<modifier::HmdModifier> m_HmdModifier{};
         std::shared_ptr<graphics::ICompositionFrameworkFactory> m_CompositionFrameworkFactory{};
 
@@ -4,7 +4,6 @@
 
 #include "output.h"
 #include "resource.h"
-#include "layer.h"
 #include <log.h>
 #include <util.h>
 #include <playsoundapi.h>
@@ -87,6 +86,8 @@ namespace output
         m_FileStream << std::fixed << std::setprecision(5);
         GetConfig()->GetBool(Cfg::RecordSamples, m_RecordSamples);
         Log("recording of samples is %s", (m_RecordSamples ? "activated" : "off"));
+        GetConfig()->GetBool(Cfg::RecordEvaluation, m_Evaluate);
+        Log("evaluation of recordings is %s", (m_Evaluate ? "activated" : "off"));
     }
 
     PoseRecorder::~PoseRecorder()
@@ -98,6 +99,10 @@ namespace output
             TraceLoggingWriteTagged(local, "PoseRecorder::Destroy", TLArg(true, "Stream_Closed"));
             m_FileStream.close();
         }
+        if (m_Evaluation.joinable())
+        {
+            m_Evaluation.join();
+        }
         TraceLoggingWriteStop(local, "PoseRecorder::Destroy");
     }
 
@@ -220,6 +225,22 @@ namespace output
                 << iO.y / angleToRadian << ";" << fO.y / angleToRadian << ";" << mO.y / angleToRadian << ";"
                 << iO.z / angleToRadian << ";" << fO.z / angleToRadian << ";" << mO.z / angleToRadian << ";"
                 << iO.x / -angleToRadian << ";" << fO.x / -angleToRadian << ";" << mO.x / -angleToRadian;
+            if (m_Evaluate)
+            {
+                m_Samples.push_back({now.count(),
+                                     {{iP.x * 1000.f,
+                                       iP.z * 1000.f,
+                                       iP.y * 1000.f,
+                                       iO.y / angleToRadian,
+                                       iO.z / angleToRadian,
+                                       iO.x / -angleToRadian}},
+                                     {{fP.x * 1000.f,
+                                       fP.z * 1000.f,
+                                       fP.y * 1000.f,
+                                       fO.y / angleToRadian,
+                                       fO.z / angleToRadian,
+                                       fO.x / -angleToRadian}}});
+            }
             if (newLine)
             {
                 m_FileStream << "\n";
@@ -242,6 +263,15 @@ namespace output
         {
             TraceLoggingWriteTagged(local, "PoseRecorder::Start", TLArg(true, "Previous_Stream_Closed"));
             m_FileStream.close();
+            if (m_Evaluate)
+            {
+                EvaluateAsync(std::exchange(m_Samples, {}));
+            }
+        }
+        m_Samples.clear();
+        if (m_Evaluate)
+        {
+            m_Samples.reserve(m_RecorderMax);
         }
         SYSTEMTIME lt;
         GetLocalTime(&lt);
@@ -286,13 +316,17 @@ namespace output
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "PoseRecorder::Stop");
 
-        std::unique_ptr<std::unique_lock<std::mutex>> lock{};
         m_Started = false;
         m_StartTime = 0;
         m_PoseRecorded = false;
         if (m_FileStream.is_open())
         {
             m_FileStream.close();
+            if (m_Evaluate)
+            {
+                std::unique_lock lock{m_RecorderMutex};
+                EvaluateAsync(std::exchange(m_Samples, {}));
+            }
             AudioOut::Execute(Event::RecorderOff);
             TraceLoggingWriteStop(local, "PoseRecorder::Stop", TLArg(true, "Stream_Closed"));
             return;
@@ -302,6 +336,141 @@ namespace output
         TraceLoggingWriteStop(local, "PoseRecorder::Stop", TLArg(false, "Stream_Closed"));
     }
 
+    void PoseRecorder::EvaluateAsync(std::vector<EvaluationSample>&& samples)
+    {
+        // keep the calculation off the frame / sampler thread, the previous evaluation is completed first
+        m_Evaluation = std::thread([previous = std::move(m_Evaluation), samples = std::move(samples)]() mutable {
+            if (previous.joinable())
+            {
+                previous.join();
+            }
+            Evaluate(samples);
+        });
+    }
+
+    void PoseRecorder::Evaluate(const std::vector<EvaluationSample>& samples)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local,
+                               "PoseRecorder::Evaluate",
+                               TLArg(static_cast<uint32_t>(samples.size()), "Samples"));
+
+        Evaluation result;
+        if (!EvaluateSamples(samples, result))
+        {
+            TraceLoggingWriteStop(local, "PoseRecorder::Evaluate", TLArg(false, "Sufficient"));
+            return;
+        }
+        Log("recording evaluation: %u samples, mean interval = %.3f ms",
+            static_cast<uint32_t>(samples.size()),
+            result.interval / 1000000.0);
+        constexpr const char* names[]{"sway", "surge", "heave", "yaw", "roll", "pitch"};
+        for (int dof = 0; dof < 6; dof++)
+        {
+            Log("%s: lag = %.1f ms (correlation = %.3f), jitter rms = %.4f %s unfiltered, %.4f %s filtered",
+                names[dof],
+                result.lag[dof] / 1000000.0,
+                result.correlation[dof],
+                result.inputJitter[dof],
+                dof < yaw ? "mm" : "deg",
+                result.outputJitter[dof],
+                dof < yaw ? "mm" : "deg");
+            TraceLoggingWriteTagged(local,
+                                    "PoseRecorder::Evaluate",
+                                    TLArg(names[dof], "Dof"),
+                                    TLArg(result.lag[dof], "Lag"),
+                                    TLArg(result.correlation[dof], "Correlation"),
+                                    TLArg(result.inputJitter[dof], "InputJitter"),
+                                    TLArg(result.outputJitter[dof], "OutputJitter"));
+        }
+
+        TraceLoggingWriteStop(local, "PoseRecorder::Evaluate", TLArg(true, "Sufficient"));
+    }
+
+    static float Difference(const float current, const float previous, const int dof)
+    {
+        const float delta = current - previous;
+        // angles are recorded in degrees, use the shorter arc on wrap around
+        return dof < yaw ? delta : fmod(delta + 540.0f, 360.0f) - 180.0f;
+    }
+
+    bool EvaluateSamples(const std::vector<EvaluationSample>& samples, Evaluation& result)
+    {
+        const size_t count = samples.size();
+        if (count < 16)
+        {
+            return false;
+        }
+        result.interval =
+            static_cast<double>(samples.back().time - samples.front().time) / static_cast<double>(count - 1);
+        // search for lag up to half a second
+        const size_t maxLag = std::min(count / 4, static_cast<size_t>(500000000.0 / std::max(result.interval, 1.0)));
+
+        for (int dof = 0; dof < 6; dof++)
+        {
+            // unwrap angles and remove static offsets before correlating input and output
+            std::vector<double> input(count), output(count);
+            double inputMean{0.0}, outputMean{0.0};
+            for (size_t i = 1; i < count; i++)
+            {
+                input[i] = input[i - 1] +
+                           Difference(samples[i].unfiltered.data[dof], samples[i - 1].unfiltered.data[dof], dof);
+                output[i] =
+                    output[i - 1] + Difference(samples[i].filtered.data[dof], samples[i - 1].filtered.data[dof], dof);
+                inputMean += input[i] / static_cast<double>(count);
+                outputMean += output[i] / static_cast<double>(count);
+            }
+            double inputNorm{0.0}, outputNorm{0.0};
+            for (size_t i = 0; i < count; i++)
+            {
+                input[i] -= inputMean;
+                output[i] -= outputMean;
+                inputNorm += input[i] * input[i];
+                outputNorm += output[i] * output[i];
+            }
+
+            // normalizing with the full length favors the smallest lag on periodic motion
+            double bestCorrelation{0.0};
+            size_t bestLag{0};
+            if (inputNorm > 0.0 && outputNorm > 0.0)
+            {
+                for (size_t lag = 0; lag <= maxLag; lag++)
+                {
+                    double sum{0.0};
+                    for (size_t i = 0; i + lag < count; i++)
+                    {
+                        sum += input[i] * output[i + lag];
+                    }
+                    const double correlation = sum / std::sqrt(inputNorm * outputNorm);
+                    if (correlation > bestCorrelation)
+                    {
+                        bestCorrelation = correlation;
+                        bestLag = lag;
+                    }
+                }
+            }
+
+            // jitter as rms of the second difference, i.e. the high frequency share of the signal
+            double inputJitter{0.0}, outputJitter{0.0};
+            for (size_t i = 1; i + 1 < count; i++)
+            {
+                const double inputDelta =
+                    Difference(samples[i + 1].unfiltered.data[dof], samples[i].unfiltered.data[dof], dof) -
+                    Difference(samples[i].unfiltered.data[dof], samples[i - 1].unfiltered.data[dof], dof);
+                const double outputDelta =
+                    Difference(samples[i + 1].filtered.data[dof], samples[i].filtered.data[dof], dof) -
+                    Difference(samples[i].filtered.data[dof], samples[i - 1].filtered.data[dof], dof);
+                inputJitter += inputDelta * inputDelta;
+                outputJitter += outputDelta * outputDelta;
+            }
+            result.lag[dof] = static_cast<double>(bestLag) * result.interval;
+            result.correlation[dof] = bestCorrelation;
+            result.inputJitter[dof] = std::sqrt(inputJitter / static_cast<double>(count - 2));
+            result.outputJitter[dof] = std::sqrt(outputJitter / static_cast<double>(count - 2));
+        }
+        return true;
+    }
+
     void PoseAndDofRecorder::AddDofValues(const Dof& dof, RecorderDofInput type)
     {
         if (!m_Started.load())
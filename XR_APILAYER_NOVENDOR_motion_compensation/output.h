@@ -1,6 +1,7 @@
 // Copyright(c) 2022 Sebastian Veith
 
 #pragma once
+#include "globals.h"
 #include "resource.h"
 
 namespace output
@@ -109,6 +110,27 @@ namespace output
         utility::Dof momentary{};
     };
 
+    // recorded input and output of the filters, evaluated for lag and jitter at the end of a recording
+    struct EvaluationSample
+    {
+        int64_t time{};
+        utility::Dof unfiltered{};
+        utility::Dof filtered{};
+    };
+
+    // lag (by cross-correlation) and residual jitter (rms of the second difference) of the filtered values per dof
+    struct Evaluation
+    {
+        double interval{};
+        std::array<double, 6> lag{};
+        std::array<double, 6> correlation{};
+        std::array<double, 6> inputJitter{};
+        std::array<double, 6> outputJitter{};
+    };
+
+    // returns false if there are too few samples for a meaningful result
+    bool EvaluateSamples(const std::vector<EvaluationSample>& samples, Evaluation& result);
+
     class RecorderBase
     {
       public:
@@ -150,6 +172,7 @@ namespace output
       protected:
         std::atomic_bool m_Started{false}, m_PoseRecorded{false};
         bool m_RecordSamples{false};
+        bool m_Evaluate{false};
         
         std::ofstream m_FileStream;
         XrTime m_FrameTime{};
@@ -166,11 +189,16 @@ namespace output
     private:
         virtual bool Start();
         virtual void Stop();
+        // evaluate on a worker thread, samples are moved out of m_Samples while holding m_RecorderMutex
+        void EvaluateAsync(std::vector<EvaluationSample>&& samples);
+        static void Evaluate(const std::vector<EvaluationSample>& samples);
 
         XrPosef m_StageToFwd{xr::math::Pose::Identity()};
         std::pair<XrVector3f, XrVector3f> m_Poses[3]{};
         XrPosef m_Ref{xr::math::Pose::Identity()}, m_InvertedRef{xr::math::Pose::Identity()};
         uint32_t m_Counter{0};
+        std::vector<EvaluationSample> m_Samples{};
+        std::thread m_Evaluation{};
     };
 
     class PoseAndDofRecorder final : public PoseRecorder
@@ -25,6 +25,9 @@
 // Standard library.
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <complex>
 #include <cstdarg>
 #include <ctime>
 #include <iomanip>
@@ -35,15 +38,24 @@
 #include <string>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <variant>
 #include <vector>
 #include <set>
 #include <map>
 #include <deque>
+#include <utility>
 #define _USE_MATH_DEFINES
 #include <cmath>
 
 using namespace std::chrono_literals;
 
+#ifdef OXRMC_PORTABLE
+// stand-ins for the platform specific headers, used to build and test the core modules on other platforms
+#include <portable.h>
+#else
 // Windows header files.
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 #define NOMINMAX
@@ -86,6 +98,7 @@ using Microsoft::WRL::ComPtr;
 #include <XrToString.h>
 #include <DirectXCollision.h>
 #include <DirectXTex.h>
+#endif
 
 // FMT formatter.
 #include <fmt/format.h>
@@ -93,6 +106,7 @@ using Microsoft::WRL::ComPtr;
 // utility
 #include <utility.h>
 
+#ifndef OXRMC_PORTABLE
 // Helpers for ComPtr manipulation.
 
 template <typename T>
@@ -118,6 +132,7 @@ T* detach(ComPtr<T>& object)
 {
     return object.Detach();
 }
+#endif
 
 template <typename T>
 constexpr inline T alignTo(T value, uint32_t pad) noexcept
@@ -6,6 +6,11 @@
 #include "filter.h"
 #include "output.h"
 #include <log.h>
+#include <util.h>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
 
 using namespace openxr_api_layer;
 using namespace log;
@@ -14,13 +19,116 @@ using namespace utility;
 
 namespace sampler
 {
-    Sampler::Sampler(tracker::VirtualTracker* tracker,
+    void IntervalHistogram::SetResolution(const int64_t resolution)
+    {
+        m_Resolution = std::max(resolution, int64_t{1});
+        Clear();
+    }
+
+    void IntervalHistogram::Add(const int64_t interval)
+    {
+        const auto bucket = static_cast<size_t>(std::max(interval, int64_t{0}) / m_Resolution);
+        m_Buckets[std::min(bucket, bucketCount)]++;
+        m_Count++;
+        m_Total += interval;
+        m_Max = std::max(m_Max, interval);
+    }
+
+    void IntervalHistogram::Clear()
+    {
+        m_Buckets.fill(0);
+        m_Count = 0;
+        m_Total = 0;
+        m_Max = 0;
+    }
+
+    uint64_t IntervalHistogram::GetCount() const
+    {
+        return m_Count;
+    }
+
+    int64_t IntervalHistogram::GetMean() const
+    {
+        return m_Count > 0 ? m_Total / static_cast<int64_t>(m_Count) : 0;
+    }
+
+    int64_t IntervalHistogram::GetMax() const
+    {
+        return m_Max;
+    }
+
+    int64_t IntervalHistogram::GetPercentile(const double percentile) const
+    {
+        const uint64_t rank =
+            std::max(static_cast<uint64_t>(std::ceil(percentile * static_cast<double>(m_Count))), uint64_t{1});
+        uint64_t accumulated{0};
+        for (size_t i = 0; i < bucketCount; i++)
+        {
+            accumulated += m_Buckets[i];
+            if (accumulated >= rank)
+            {
+                return std::min(static_cast<int64_t>(i + 1) * m_Resolution, m_Max);
+            }
+        }
+        return m_Max;
+    }
+
+    Sampler::Sampler(SampleSource* source,
                      const std::vector<utility::DofValue>& relevantValues,
                      const std::shared_ptr<output::RecorderBase>& recorder)
-        : m_Tracker(tracker), m_Recorder(recorder)
+        : m_Source(source), m_Recorder(recorder), m_RelevantValues(relevantValues)
     {
-        m_Stabilizer = std::make_shared<filter::BiQuadStabilizer>(relevantValues);
+        int order{2};
+        GetConfig()->GetInt(Cfg::StabilizerOrder, order);
+        if (4 == order)
+        {
+            m_Stabilizer = std::make_shared<filter::BiQuadStabilizer<2>>(relevantValues);
+        }
+        else
+        {
+            if (2 != order)
+            {
+                ErrorLog("%s: invalid stabilizer filter order: %d, using 2", __FUNCTION__, order);
+            }
+            m_Stabilizer = std::make_shared<filter::BiQuadStabilizer<1>>(relevantValues);
+        }
+        bool autoTune{false};
+        GetConfig()->GetBool(Cfg::StabilizerAutoTune, autoTune);
+        if (autoTune)
+        {
+            m_Analyzer = std::make_unique<filter::CutoffAnalyzer>(relevantValues);
+        }
         GetConfig()->GetBool(Cfg::RecordSamples, m_SampleRecording);
+        float interval;
+        if (GetConfig()->GetFloat(Cfg::StabilizerInterval, interval) && interval > 0.f)
+        {
+            m_Interval = std::chrono::microseconds(static_cast<int64_t>(interval * 1000.f));
+        }
+        Log("stabilizer sampling interval: %.3f ms", static_cast<double>(m_Interval.count()) / 1000.0);
+        GetConfig()->GetBool(Cfg::StabilizerPreciseTiming, m_PreciseTiming);
+        float spinBudget;
+        if (GetConfig()->GetFloat(Cfg::StabilizerSpinBudget, spinBudget))
+        {
+            m_SpinBudget = std::chrono::microseconds(static_cast<int64_t>(std::max(spinBudget, 0.f)));
+        }
+        Log("stabilizer precise timing is %s, spin budget: %lld us",
+            m_PreciseTiming ? "on" : "off",
+            m_SpinBudget.count());
+        float extrapolationLimit;
+        if (GetConfig()->GetFloat(Cfg::StabilizerExtrapolation, extrapolationLimit))
+        {
+            m_ExtrapolationLimit = static_cast<int64_t>(std::max(extrapolationLimit, 0.f) * 1000000.0);
+        }
+        Log("stabilizer output is %s, extrapolation limit: %.3f ms",
+            GetTimeConverter()->IsAvailable() ? "aligned with display time" : "not time aligned",
+            static_cast<double>(m_ExtrapolationLimit) / 1000000.0);
+        GetConfig()->GetBool(Cfg::StabilizerChangeDriven, m_ChangeDriven);
+        Log("stabilizer is fed %s", m_ChangeDriven ? "with changed source data only" : "at every sampling cycle");
+        float statisticsInterval;
+        if (GetConfig()->GetFloat(Cfg::SamplerStatistics, statisticsInterval))
+        {
+            m_StatisticsInterval = static_cast<int64_t>(std::max(statisticsInterval, 0.f) * 1000000000.0);
+        }
     }
 
     Sampler::~Sampler()
@@ -43,10 +151,11 @@ namespace sampler
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "Sampler::ReadData", TLArg(now, "Now"));
 
+        const auto start = std::chrono::steady_clock::now();
         if (!m_IsSampling.load())
         {
             // try to reconnect
-            if (m_Tracker->GetSource()->Open(0))
+            if (m_Source->GetSource()->Open(0))
             {
                 TraceLoggingWriteTagged(local, "Sampler::ReadData", TLArg(true, "Restart"));
                 StartSampling();
@@ -57,20 +166,108 @@ namespace sampler
                 return false;
             }
         }
-        m_Stabilizer->Read(dof);
+        if (!ReadAligned(dof, now))
+        {
+            m_Stabilizer->Read(dof);
+        }
         if (m_SampleRecording && m_Recorder)
         {
             Dof momentary;
-            if (m_Tracker->ReadSource(now, momentary))
+            if (m_Source->ReadSource(now, momentary))
             {
                 m_Recorder->AddDofValues(momentary, Momentary);
             }
         }
 
+        // duration of reads on the frame thread(s)
+        const auto duration = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        m_Reads.fetch_add(1, std::memory_order_relaxed);
+        m_ReadTotal.fetch_add(duration, std::memory_order_relaxed);
+        uint64_t max = m_ReadMax.load(std::memory_order_relaxed);
+        while (duration > max && !m_ReadMax.compare_exchange_weak(max, duration, std::memory_order_relaxed))
+        {
+        }
+
         TraceLoggingWriteStop(local, "Sampler::ReadData", TLArg(true, "Success"));
         return true;
     }
 
+    bool Sampler::ReadAligned(Dof& dof, const XrTime time) const
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Sampler::ReadAligned", TLArg(time, "Time"));
+
+        int64_t steadyTime;
+        if (!GetTimeConverter()->ToSteadyClock(time, steadyTime))
+        {
+            TraceLoggingWriteStop(local, "Sampler::ReadAligned", TLArg(false, "Converted"));
+            return false;
+        }
+        Neighborhood<Dof> neighborhood;
+        m_History.Bracket(steadyTime, extrapolationDistance, neighborhood);
+        if (!neighborhood.lower && !neighborhood.upper)
+        {
+            TraceLoggingWriteStop(local, "Sampler::ReadAligned", TLArg(false, "Available"));
+            return false;
+        }
+
+        // angles (in degrees) are interpolated along the shorter arc
+        auto Difference = [](const Dof& from, const Dof& to, const DofValue value) -> float {
+            const float delta = to.data[value] - from.data[value];
+            return value >= yaw ? std::fmod(delta + 540.0f, 360.0f) - 180.0f : delta;
+        };
+
+        int64_t offset{0};
+        if (neighborhood.lower && neighborhood.upper)
+        {
+            const auto& [lowerTime, lower] = *neighborhood.lower;
+            const auto& [upperTime, upper] = *neighborhood.upper;
+            const float alpha = static_cast<float>(steadyTime - lowerTime) / static_cast<float>(upperTime - lowerTime);
+            for (const DofValue value : m_RelevantValues)
+            {
+                dof.data[value] = lower.data[value] + alpha * Difference(lower, upper, value);
+            }
+        }
+        else if (neighborhood.upper)
+        {
+            // requested time precedes history
+            const auto& [upperTime, upper] = *neighborhood.upper;
+            offset = steadyTime - upperTime;
+            for (const DofValue value : m_RelevantValues)
+            {
+                dof.data[value] = upper.data[value];
+            }
+        }
+        else
+        {
+            // requested time is ahead of the latest sample, continue its rate of change up to the configured limit
+            const auto& [lowerTime, lower] = *neighborhood.lower;
+            offset = steadyTime - lowerTime;
+            for (const DofValue value : m_RelevantValues)
+            {
+                dof.data[value] = lower.data[value];
+            }
+            if (neighborhood.lowerBase && m_ExtrapolationLimit > 0)
+            {
+                const auto& [baseTime, base] = *neighborhood.lowerBase;
+                const float factor = static_cast<float>(std::min(offset, m_ExtrapolationLimit)) /
+                                     static_cast<float>(lowerTime - baseTime);
+                for (const DofValue value : m_RelevantValues)
+                {
+                    dof.data[value] += factor * Difference(base, lower, value);
+                }
+            }
+        }
+
+        TraceLoggingWriteStop(local,
+                              "Sampler::ReadAligned",
+                              TLArg(steadyTime, "SteadyTime"),
+                              TLArg(offset, "Offset"),
+                              TLArg(xr::ToString(dof).c_str(), "Dof"));
+        return true;
+    }
+
     void Sampler::StartSampling()
     {
         TraceLocalActivity(local);
@@ -120,33 +317,275 @@ namespace sampler
     {
         using namespace std::chrono;
 
+        if (m_PreciseTiming)
+        {
+            m_Timer = CreateWaitableTimerExW(nullptr,
+                                             nullptr,
+                                             CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                             TIMER_MODIFY_STATE | SYNCHRONIZE);
+            if (!m_Timer)
+            {
+                ErrorLog("%s: unable to create high resolution timer: %s", __FUNCTION__, LastErrorMsg().c_str());
+            }
+        }
+
         const nanoseconds start = steady_clock::now().time_since_epoch();
+        m_LastCpuTime = CpuTime();
         m_Stabilizer->SetStartTime(start.count());
+        m_History.Clear();
+        m_LastChange = 0;
+        m_LastInsert = 0;
+        m_SourcePeriod = m_Interval.count() * 1000;
+        m_Analyzed = start.count() - m_Interval.count() * 1000;
+        m_LastStatistics = start.count();
+        m_Intervals.SetResolution(m_Interval.count() * 1000 / bucketsPerInterval);
 
+        steady_clock::time_point deadline = steady_clock::now();
+        steady_clock::time_point previous{};
         while (m_IsSampling.load())
         {
             // set timing
             auto now = steady_clock::now();
             const int64_t time = time_point_cast<nanoseconds>(now).time_since_epoch().count();
+            const bool missed = now > deadline + m_Interval;
+            if (previous.time_since_epoch().count() > 0)
+            {
+                AddInterval(duration_cast<nanoseconds>(now - previous).count(), missed, time);
+            }
+            previous = now;
 
             // sample value
             Dof dof;
-            if (!m_Tracker->ReadSource(time, dof))
+            if (!m_Source->ReadSource(time, dof))
             {
                 break;
             }
-            m_Stabilizer->Insert(dof, time);
-
-            // record sample
-            if (m_SampleRecording && m_Recorder)
+            const Dof previous = m_LastSample;
+            const bool changed = IsNewSample(dof, time);
+            if (m_Analyzer)
             {
-                m_Recorder->AddDofValues(dof, Sampled);
-                m_Recorder->Write(true);
+                FeedAnalyzer(previous, dof, time);
             }
+            if (changed || !m_ChangeDriven || time - m_LastInsert >= holdFactor * m_SourcePeriod)
+            {
+                // unchanged values are only fed after a while, to let the filter settle while the source is idle
+                m_LastInsert = time;
+
+                const auto insertStart = steady_clock::now();
+                m_Stabilizer->Insert(dof, time);
+                const int64_t insertDuration = duration_cast<nanoseconds>(steady_clock::now() - insertStart).count();
+                m_Inserts++;
+                m_InsertTotal += insertDuration;
+                m_InsertMax = std::max(m_InsertMax, insertDuration);
+                Dof stabilized{};
+                m_Stabilizer->Read(stabilized);
+                bool existing;
+                m_History.Insert(time, stabilized, true, existing);
 
-            // wait for next sampling cycle
-            std::this_thread::sleep_until(now + m_Interval);
+                // record sample
+                if (m_SampleRecording && m_Recorder)
+                {
+                    m_Recorder->AddDofValues(dof, Sampled);
+                    m_Recorder->Write(true);
+                }
+            }
+
+            // wait for next sampling cycle at fixed rate, restart schedule after missing a whole cycle
+            deadline = missed ? now + m_Interval : deadline + m_Interval;
+            if (m_ChangeDriven && changed)
+            {
+                // skip polling until shortly before the next update of the source is expected
+                deadline = std::max(deadline, now + nanoseconds(m_SourcePeriod) - m_Interval);
+            }
+            WaitUntil(deadline);
         }
         m_IsSampling = false;
+
+        LogStatistics();
+        if (m_Timer)
+        {
+            CloseHandle(m_Timer);
+            m_Timer = nullptr;
+        }
+    }
+
+    bool Sampler::IsNewSample(const Dof& dof, const int64_t time)
+    {
+        if (m_LastChange > 0 && 0 == memcmp(&dof, &m_LastSample, sizeof(Dof)))
+        {
+            m_Duplicates++;
+            return false;
+        }
+        m_Updates++;
+        m_LastSample = dof;
+        const int64_t previous = std::exchange(m_LastChange, time);
+        if (const int64_t interval = time - previous; previous > 0 && interval < maxSourcePeriod)
+        {
+            // track update rate of the source, limited to the sampling rate
+            m_SourcePeriod += static_cast<int64_t>(static_cast<double>(interval - m_SourcePeriod) * periodSmoothing);
+            m_SourcePeriod = std::max(m_SourcePeriod, static_cast<int64_t>(m_Interval.count()) * 1000);
+        }
+        return true;
+    }
+
+    void Sampler::FeedAnalyzer(const Dof& previous, const Dof& dof, const int64_t time)
+    {
+        // the spectral analysis requires regularly spaced samples: cycles skipped while polling is paused (or missed)
+        // are filled with the preceding source value, as if it had been polled at the sampling rate
+        const int64_t interval = m_Interval.count() * 1000;
+        m_Analyzed = std::max(m_Analyzed, time - maxSourcePeriod);
+        for (int64_t next = m_Analyzed + interval; next <= time + interval / 2; next += interval)
+        {
+            m_Analyzed = next;
+            const bool skipped = next + interval <= time + interval / 2;
+
+            // adjust cutoff frequencies to the analyzed spectrum
+            DofValue value;
+            if (float cutoff; m_Analyzer->Add(skipped ? previous : dof, next, value, cutoff))
+            {
+                m_Stabilizer->SetCutoff(value, cutoff);
+            }
+        }
+    }
+
+    void Sampler::WaitUntil(const std::chrono::steady_clock::time_point deadline) const
+    {
+        using namespace std::chrono;
+
+        if (!m_PreciseTiming)
+        {
+            std::this_thread::sleep_until(deadline);
+            return;
+        }
+
+        const steady_clock::time_point wakeUp = deadline - m_SpinBudget;
+        const steady_clock::time_point now = steady_clock::now();
+        if (wakeUp > now)
+        {
+            // negative due time is relative, in 100 ns units
+            LARGE_INTEGER dueTime;
+            dueTime.QuadPart = -std::max(duration_cast<nanoseconds>(wakeUp - now).count() / 100, int64_t{1});
+            if (!m_Timer || !SetWaitableTimer(m_Timer, &dueTime, 0, nullptr, nullptr, FALSE) ||
+                WAIT_OBJECT_0 != WaitForSingleObject(m_Timer, INFINITE))
+            {
+                std::this_thread::sleep_until(wakeUp);
+            }
+        }
+        while (steady_clock::now() < deadline)
+        {
+            YieldProcessor();
+        }
+    }
+
+    void Sampler::AddInterval(const int64_t interval, const bool missed, const int64_t now)
+    {
+        m_Intervals.Add(interval);
+        if (missed)
+        {
+            m_Missed++;
+        }
+        if (m_StatisticsInterval > 0 && now - m_LastStatistics >= m_StatisticsInterval)
+        {
+            LogStatistics();
+            m_LastStatistics = now;
+        }
+    }
+
+    void Sampler::LogStatistics()
+    {
+        const uint64_t count = m_Intervals.GetCount();
+        if (0 == count)
+        {
+            return;
+        }
+        const int64_t mean = m_Intervals.GetMean();
+        const int64_t p99 = m_Intervals.GetPercentile(0.99);
+        const int64_t max = m_Intervals.GetMax();
+
+        // change driven sampling pauses polling between source updates, intervals are measured between polls then
+        Log("sampler %s over %llu samples: mean interval = %.3f ms, p99 = %.3f ms, max = %.3f ms, %llu missed cycles",
+            m_ChangeDriven ? "poll timing (change driven, not source timestamps)" : "timing",
+            count,
+            static_cast<double>(mean) / 1000000.0,
+            static_cast<double>(p99) / 1000000.0,
+            static_cast<double>(max) / 1000000.0,
+            m_Missed);
+        if (m_ChangeDriven)
+        {
+            Log("sampler source: %llu updates, %llu unchanged reads, estimated update rate = %.1f Hz",
+                m_Updates,
+                m_Duplicates,
+                1000000000.0 / static_cast<double>(m_SourcePeriod));
+        }
+        TraceLoggingWrite(g_traceProvider,
+                          "Sampler::LogStatistics",
+                          TLArg(count, "Samples"),
+                          TLArg(m_ChangeDriven, "ChangeDriven"),
+                          TLArg(mean, "MeanInterval"),
+                          TLArg(p99, "P99Interval"),
+                          TLArg(max, "MaxInterval"),
+                          TLArg(m_Missed, "Missed"),
+                          TLArg(m_Updates, "SourceUpdates"),
+                          TLArg(m_Duplicates, "UnchangedReads"),
+                          TLArg(m_SourcePeriod, "SourcePeriod"));
+
+        // load and latency on sampler and frame thread(s)
+        const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+        const int64_t cpuTime = CpuTime();
+        const double cpuLoad = now > m_LastStatistics ? 100.0 * static_cast<double>(cpuTime - m_LastCpuTime) /
+                                                            static_cast<double>(now - m_LastStatistics)
+                                                      : 0.0;
+        m_LastCpuTime = cpuTime;
+        const uint64_t reads = m_Reads.exchange(0, std::memory_order_relaxed);
+        const uint64_t readTotal = m_ReadTotal.exchange(0, std::memory_order_relaxed);
+        const uint64_t readMax = m_ReadMax.exchange(0, std::memory_order_relaxed);
+        Log("sampler load: cpu usage = %.2f %% of one core, filter insert mean = %.3f us, max = %.3f us, "
+            "%llu reads: mean = %.3f us, max = %.3f us",
+            cpuLoad,
+            m_Inserts > 0 ? static_cast<double>(m_InsertTotal) / static_cast<double>(m_Inserts) / 1000.0 : 0.0,
+            static_cast<double>(m_InsertMax) / 1000.0,
+            reads,
+            reads > 0 ? static_cast<double>(readTotal) / static_cast<double>(reads) / 1000.0 : 0.0,
+            static_cast<double>(readMax) / 1000.0);
+        // contention between sampler thread (writer) and frame thread(s) on the history of stabilized samples
+        Log("sampler history: %llu read retries, %llu locked reads, %llu lock waits due to concurrent access",
+            m_History.GetReadRetries(),
+            m_History.GetLockedReads(),
+            m_History.GetLockWaits());
+        m_Stabilizer->LogStatistics();
+        TraceLoggingWrite(g_traceProvider,
+                          "Sampler::LogStatistics_Load",
+                          TLArg(cpuLoad, "CpuLoad"),
+                          TLArg(m_Inserts, "Inserts"),
+                          TLArg(m_InsertTotal, "InsertTotal"),
+                          TLArg(m_InsertMax, "InsertMax"),
+                          TLArg(reads, "Reads"),
+                          TLArg(readTotal, "ReadTotal"),
+                          TLArg(readMax, "ReadMax"),
+                          TLArg(m_History.GetReadRetries(), "HistoryReadRetries"),
+                          TLArg(m_History.GetLockedReads(), "HistoryLockedReads"),
+                          TLArg(m_History.GetLockWaits(), "HistoryLockWaits"));
+
+        m_Intervals.Clear();
+        m_Missed = 0;
+        m_Updates = 0;
+        m_Duplicates = 0;
+        m_Inserts = 0;
+        m_InsertTotal = 0;
+        m_InsertMax = 0;
+    }
+
+    int64_t Sampler::CpuTime()
+    {
+        // kernel and user time of the calling thread, in ns
+        FILETIME creation, exit, kernel, user;
+        if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        {
+            return 0;
+        }
+        const auto ToNanoseconds = [](const FILETIME& time) {
+            return ((static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100;
+        };
+        return ToNanoseconds(kernel) + ToNanoseconds(user);
     }
 } // namespace sampler
\ No newline at end of file
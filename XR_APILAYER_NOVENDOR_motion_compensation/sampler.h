@@ -2,20 +2,48 @@
 
 #pragma once
 
-#include "tracker.h"
+#include "utility.h"
 #include "filter.h"
 #include "output.h"
 
-namespace tracker
-{
-    class VirtualTracker;
-}
 namespace sampler
 {
+    // provider of the values to sample, implemented by the virtual trackers
+    class SampleSource
+    {
+      public:
+        virtual ~SampleSource() = default;
+        virtual utility::DataSource* GetSource() = 0;
+        virtual bool ReadSource(XrTime time, utility::Dof& dof) = 0;
+    };
+
+    // distribution of sampling intervals with constant memory and insertion cost
+    // bucket width is a fraction of the sampling interval, intervals beyond the range share the last bucket
+    class IntervalHistogram
+    {
+      public:
+        void SetResolution(int64_t resolution);
+        void Add(int64_t interval);
+        void Clear();
+        [[nodiscard]] uint64_t GetCount() const;
+        [[nodiscard]] int64_t GetMean() const;
+        [[nodiscard]] int64_t GetMax() const;
+        // upper limit of the bucket containing the percentile, limited to the maximum interval
+        [[nodiscard]] int64_t GetPercentile(double percentile) const;
+
+      private:
+        static constexpr size_t bucketCount{500};
+        std::array<uint64_t, bucketCount + 1> m_Buckets{};
+        int64_t m_Resolution{20000};
+        uint64_t m_Count{0};
+        int64_t m_Total{0};
+        int64_t m_Max{0};
+    };
+
     class Sampler
     {
       public:
-        Sampler(tracker::VirtualTracker* tracker,
+        Sampler(SampleSource* source,
                 const std::vector<utility::DofValue>& relevantValues,
                 const std::shared_ptr<output::RecorderBase>& recorder);
         ~Sampler();
@@ -26,14 +54,63 @@ namespace sampler
         bool ReadData(utility::Dof& dof, XrTime now);
 
       private:
+        bool ReadAligned(utility::Dof& dof, XrTime time) const;
+        bool IsNewSample(const utility::Dof& dof, int64_t time);
+        void FeedAnalyzer(const utility::Dof& previous, const utility::Dof& dof, int64_t time);
         void DoSampling();
+        void WaitUntil(std::chrono::steady_clock::time_point deadline) const;
+        void AddInterval(int64_t interval, bool missed, int64_t now);
+        void LogStatistics();
+        static int64_t CpuTime();
 
         std::atomic_bool m_IsSampling{false};
         std::thread* m_Thread{nullptr};
-        tracker::VirtualTracker* m_Tracker{nullptr};
+        SampleSource* m_Source{nullptr};
         std::shared_ptr<filter::StabilizerBase> m_Stabilizer{};
+        std::unique_ptr<filter::CutoffAnalyzer> m_Analyzer{};
+        int64_t m_Analyzed{0};
         std::chrono::microseconds m_Interval{1ms};
         bool m_SampleRecording{false};
         std::shared_ptr<output::RecorderBase> m_Recorder{};
+        std::vector<utility::DofValue> m_RelevantValues;
+
+        // stabilized samples with sampling time, used to align the output with the requested (display) time
+        static constexpr size_t historyCapacity{128};
+        static constexpr size_t extrapolationDistance{8};
+        utility::RingBuffer<utility::Dof> m_History{historyCapacity};
+        int64_t m_ExtrapolationLimit{0};
+
+        // optionally wait on high resolution timer and busy wait for the last part of each sampling cycle
+        bool m_PreciseTiming{false};
+        std::chrono::microseconds m_SpinBudget{0us};
+        HANDLE m_Timer{nullptr};
+
+        // feed the stabilizer only with changed source data, polling is paused until the next update is expected
+        bool m_ChangeDriven{false};
+        static constexpr int64_t holdFactor{2};
+        static constexpr int64_t maxSourcePeriod{100000000};
+        static constexpr double periodSmoothing{0.1};
+        utility::Dof m_LastSample{};
+        int64_t m_LastChange{0};
+        int64_t m_LastInsert{0};
+        int64_t m_SourcePeriod{1000000};
+        uint64_t m_Updates{0};
+        uint64_t m_Duplicates{0};
+
+        // sampling interval statistics, logged on stop and periodically, if sampler_statistics_interval is set
+        static constexpr int64_t bucketsPerInterval{50};
+        IntervalHistogram m_Intervals{};
+        uint64_t m_Missed{0};
+        int64_t m_StatisticsInterval{300000000000};
+        int64_t m_LastStatistics{0};
+
+        // load and latency statistics, logged along with sampling intervals
+        int64_t m_LastCpuTime{0};
+        uint64_t m_Inserts{0};
+        int64_t m_InsertTotal{0};
+        int64_t m_InsertMax{0};
+        std::atomic<uint64_t> m_Reads{0};
+        std::atomic<uint64_t> m_ReadTotal{0};
+        std::atomic<uint64_t> m_ReadMax{0};
     };
 } // namespace sampler
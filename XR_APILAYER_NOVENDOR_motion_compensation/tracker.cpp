@@ -37,20 +37,35 @@ namespace tracker
             DebugLog("delta(%u) reused", time);
             return true;
         }
-        if (XrPosef curPose{Pose::Identity()}; GetPose(curPose, session, time))
+        bool poseAvailable;
+        XrPosef curPose{Pose::Identity()};
+        {
+            PipelineTimer::Scope timing(PipelineTimer::TrackerPose);
+            poseAvailable = GetPose(curPose, session, time);
+        }
+        if (poseAvailable)
         {
             m_Recorder->AddFrameTime(time);
             m_Recorder->AddPose(m_ReferencePose, Reference);
             m_Recorder->AddPose(curPose, Unfiltered);
-            
-            ApplyFilters(curPose);
+
+            {
+                PipelineTimer::Scope timing(PipelineTimer::Filter);
+                ApplyFilters(curPose, time);
+            }
             m_Recorder->AddPose(curPose, Filtered);
-            
-            ApplyModifier(curPose);
+
+            {
+                PipelineTimer::Scope timing(PipelineTimer::TrackerModifier);
+                ApplyModifier(curPose);
+            }
             m_Recorder->AddPose(curPose, Modified);
 
             // calculate difference toward reference pose
-            poseDelta = Pose::Multiply(Pose::Invert(curPose), m_ReferencePose);
+            {
+                PipelineTimer::Scope timing(PipelineTimer::Delta);
+                poseDelta = Pose::Multiply(Pose::Invert(curPose), m_ReferencePose);
+            }
             m_Recorder->Write();
 
             if (!m_FallBackUsed)
@@ -270,17 +285,6 @@ namespace tracker
         return angle;
     }
 
-    TrackerBase::~TrackerBase()
-    {
-        TraceLocalActivity(local);
-        TraceLoggingWriteStart(local, "TrackerBase::~TrackerBase");
-
-        delete m_TransFilter;
-        delete m_RotFilter;
-
-        TraceLoggingWriteStop(local, "TrackerBase::~TrackerBase");
-    }
-
     bool TrackerBase::Init()
     {
         TraceLocalActivity(local);
@@ -316,12 +320,31 @@ namespace tracker
         // set up filters
         int orderTrans = 2, orderRot = 2;
         float strengthTrans = 0.0f, strengthRot = 0.0f;
-        if (!GetConfig()->GetInt(Cfg::TransOrder, orderTrans) || !GetConfig()->GetInt(Cfg::RotOrder, orderRot) ||
+        bool timeBasedTrans = false, timeBasedRot = false;
+        std::string typeTrans{"ema"}, typeRot{"slerp"};
+        if (!GetConfig()->GetString(Cfg::TransType, typeTrans) || !GetConfig()->GetString(Cfg::RotType, typeRot) ||
+            !GetConfig()->GetInt(Cfg::TransOrder, orderTrans) || !GetConfig()->GetInt(Cfg::RotOrder, orderRot) ||
             !GetConfig()->GetFloat(Cfg::TransStrength, strengthTrans) ||
-            !GetConfig()->GetFloat(Cfg::RotStrength, strengthRot))
+            !GetConfig()->GetFloat(Cfg::RotStrength, strengthRot) ||
+            !GetConfig()->GetBool(Cfg::TransTimeBased, timeBasedTrans) ||
+            !GetConfig()->GetBool(Cfg::RotTimeBased, timeBasedRot))
         {
             ErrorLog("%s: unable to read configured values for filters", __FUNCTION__);
         }
+        const bool oneEuroTrans = "one_euro" == typeTrans, oneEuroRot = "one_euro" == typeRot;
+        const bool kalmanTrans = "kalman" == typeTrans, kalmanRot = "kalman" == typeRot;
+        if (!oneEuroTrans && !kalmanTrans && "ema" != typeTrans)
+        {
+            ErrorLog("%s: invalid type for translational filter: %s", __FUNCTION__, typeTrans.c_str());
+            TraceLoggingWriteStop(local, "TrackerBase::LoadFilters", TLArg(false, "Success"));
+            return false;
+        }
+        if (!oneEuroRot && !kalmanRot && "slerp" != typeRot)
+        {
+            ErrorLog("%s: invalid type for rotational filter: %s", __FUNCTION__, typeRot.c_str());
+            TraceLoggingWriteStop(local, "TrackerBase::LoadFilters", TLArg(false, "Success"));
+            return false;
+        }
         if (1 > orderTrans || 3 < orderTrans)
         {
             ErrorLog("%s: invalid order for translational filter: %d", __FUNCTION__, orderTrans);
@@ -334,28 +357,47 @@ namespace tracker
             TraceLoggingWriteStop(local, "TrackerBase::LoadFilters", TLArg(false, "Success"));
             return false;
         }
-        // remove previous filter objects
-
-        delete m_TransFilter;
-        delete m_RotFilter;
-
         m_TransStrength = strengthTrans;
         m_RotStrength = strengthRot;
 
-        Log("translational filter stages: %d", orderTrans);
+        Log("translational filter type: %s", typeTrans.c_str());
         Log("translational filter strength: %f", m_TransStrength);
-        m_TransFilter = 1 == orderTrans   ? new filter::SingleEmaFilter(m_TransStrength)
-                        : 2 == orderTrans ? new filter::DoubleEmaFilter(m_TransStrength)
-                                          : new filter::TripleEmaFilter(m_TransStrength);
+        if (oneEuroTrans)
+        {
+            m_TransFilter.emplace<filter::OneEuroFilter<XrVector3f>>(m_TransStrength);
+        }
+        else if (kalmanTrans)
+        {
+            m_TransFilter.emplace<filter::KalmanFilter<XrVector3f>>(m_TransStrength);
+        }
+        else
+        {
+            Log("translational filter stages: %d", orderTrans);
+            filter::SetOrder<filter::EmaFilter>(m_TransFilter, orderTrans, m_TransStrength);
+            std::visit([timeBasedTrans](auto& filter) { filter.SetTimeBased(timeBasedTrans); }, m_TransFilter);
+        }
 
-        Log("rotational filter stages: %d", orderRot);
+        Log("rotational filter type: %s", typeRot.c_str());
         Log("rotational filter strength: %f", m_RotStrength);
-        m_RotFilter = 1 == orderRot   ? new filter::SingleSlerpFilter(m_RotStrength)
-                      : 2 == orderRot ? new filter::DoubleSlerpFilter(m_RotStrength)
-                                      : new filter::TripleSlerpFilter(m_RotStrength);
+        if (oneEuroRot)
+        {
+            m_RotFilter.emplace<filter::OneEuroFilter<XrQuaternionf>>(m_RotStrength);
+        }
+        else if (kalmanRot)
+        {
+            m_RotFilter.emplace<filter::KalmanFilter<XrQuaternionf>>(m_RotStrength);
+        }
+        else
+        {
+            Log("rotational filter stages: %d", orderRot);
+            filter::SetOrder<filter::SlerpFilter>(m_RotFilter, orderRot, m_RotStrength);
+            std::visit([timeBasedRot](auto& filter) { filter.SetTimeBased(timeBasedRot); }, m_RotFilter);
+        }
 
         TraceLoggingWriteStop(local,
                               "TrackerBase::LoadFilters",
+                              TLArg(typeTrans.c_str(), "TypeTrans"),
+                              TLArg(typeRot.c_str(), "TypeRot"),
                               TLArg(orderTrans, "OrderTrans"),
                               TLArg(m_TransStrength, "TransStrength"),
                               TLArg(orderRot, "OrderRot"),
@@ -379,13 +421,15 @@ namespace tracker
         const float newValue = *currentValue + (increase ? amount : -amount);
         if (trans)
         {
-            *currentValue = m_TransFilter->SetStrength(newValue);
+            *currentValue =
+                std::visit([newValue](auto& filter) { return filter.SetStrength(newValue); }, m_TransFilter);
             GetConfig()->SetValue(Cfg::TransStrength, *currentValue);
             Log("translational filter strength %screased to %f", increase ? "in" : "de", *currentValue);
         }
         else
         {
-            *currentValue = m_RotFilter->SetStrength(newValue);
+            *currentValue =
+                std::visit([newValue](auto& filter) { return filter.SetStrength(newValue); }, m_RotFilter);
             GetConfig()->SetValue(Cfg::RotStrength, *currentValue);
             Log("rotational filter strength %screased to %f", increase ? "in" : "de", *currentValue);
         }
@@ -483,8 +527,8 @@ namespace tracker
         TraceLocalActivity(local);
         TraceLoggingWriteStart(local, "TrackerBase::SetReferencePose", TLArg(xr::ToString(pose).c_str(), "Pose"));
 
-        m_TransFilter->Reset(pose.position);
-        m_RotFilter->Reset(pose.orientation);
+        std::visit([&pose](auto& filter) { filter.Reset(pose.position); }, m_TransFilter);
+        std::visit([&pose](auto& filter) { filter.Reset(pose.orientation); }, m_RotFilter);
         m_Calibrated = true;
         ControllerBase::SetReferencePose(pose);
 
@@ -501,16 +545,19 @@ namespace tracker
         return m_Recorder->Toggle(m_Calibrated);
     }
 
-    void TrackerBase::ApplyFilters(XrPosef& pose)
+    void TrackerBase::ApplyFilters(XrPosef& pose, XrTime time)
     {
          TraceLocalActivity(local);
-         TraceLoggingWriteStart(local, "TrackerBase::ApplyFilters", TLArg(xr::ToString(pose).c_str(), "Pose"));
+         TraceLoggingWriteStart(local,
+                                "TrackerBase::ApplyFilters",
+                                TLArg(xr::ToString(pose).c_str(), "Pose"),
+                                TLArg(time, "Time"));
 
          // apply translational filter
-         m_TransFilter->Filter(pose.position);
+         std::visit([&pose, time](auto& filter) { filter.Filter(pose.position, time); }, m_TransFilter);
 
          // apply rotational filter
-         m_RotFilter->Filter(pose.orientation);
+         std::visit([&pose, time](auto& filter) { filter.Filter(pose.orientation, time); }, m_RotFilter);
 
          TraceLoggingWriteStop(local, "TrackerBase::ApplyFilters", TLArg(xr::ToString(pose).c_str(), "NewPose"));
     }
@@ -1302,6 +1349,96 @@ namespace tracker
         return rigPose;
     }
 
+    bool ReplayTracker::Init()
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "ReplayTracker::Init");
+
+        bool success = FlyPtTracker::Init();
+        std::string file;
+        if (GetConfig()->GetString(Cfg::TrackerReplayFile, file) && !file.empty() && "none" != file)
+        {
+            std::filesystem::path path(file);
+            if (path.is_relative())
+            {
+                path = localAppData / path;
+            }
+            m_Recording.SetFile(path);
+            Log("recording file used for replay: %s", path.string().c_str());
+        }
+        else
+        {
+            ErrorLog("%s: no recording file specified for replay", __FUNCTION__);
+            success = false;
+        }
+
+        TraceLoggingWriteStop(local, "ReplayTracker::Init", TLArg(success, "Success"));
+        return success;
+    }
+
+    bool ReplayTracker::LazyInit(const XrTime time)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local,
+                               "ReplayTracker::LazyInit",
+                               TLArg(time, "Time"),
+                               TLArg(m_SkipLazyInit, "SkipLazyInit"));
+
+        bool success = true;
+        if (!m_SkipLazyInit)
+        {
+            success = m_Recording.Open(time);
+        }
+        m_SkipLazyInit = success;
+
+        TraceLoggingWriteStop(local, "ReplayTracker::LazyInit", TLArg(success, "Success"));
+        return success;
+    }
+
+    utility::DataSource* ReplayTracker::GetSource()
+    {
+        return &m_Recording;
+    }
+
+    bool ReplayTracker::ReadSource(XrTime now, Dof& dof)
+    {
+        return m_Recording.Read(&dof, sizeof(dof), now);
+    }
+
+    bool SyntheticTracker::Init()
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "SyntheticTracker::Init");
+
+        const bool success = FlyPtTracker::Init();
+        std::string signal{"mixed"};
+        float rate{250.f}, noise{0.01f}, dropouts{0.f};
+        GetConfig()->GetString(Cfg::TrackerSyntheticSignal, signal);
+        GetConfig()->GetFloat(Cfg::TrackerSyntheticRate, rate);
+        GetConfig()->GetFloat(Cfg::TrackerSyntheticNoise, noise);
+        GetConfig()->GetFloat(Cfg::TrackerSyntheticDropouts, dropouts);
+        m_Synthetic.Configure(signal, rate, noise, dropouts);
+
+        TraceLoggingWriteStop(local, "SyntheticTracker::Init", TLArg(success, "Success"));
+        return success;
+    }
+
+    bool SyntheticTracker::LazyInit(const XrTime time)
+    {
+        m_SkipLazyInit = m_Synthetic.Open(time);
+        return m_SkipLazyInit;
+    }
+
+    utility::DataSource* SyntheticTracker::GetSource()
+    {
+        return &m_Synthetic;
+    }
+
+    bool SyntheticTracker::ReadSource(XrTime now, Dof& dof)
+    {
+        return m_Synthetic.Read(&dof, sizeof(dof), now);
+    }
+
     XrPosef SrsTracker::DataToPose(const Dof& dof)
     {
         TraceLocalActivity(local);
@@ -1643,6 +1780,18 @@ namespace tracker
                 TraceLoggingWriteStop(local, "GetTracker", TLPArg(trackerType.c_str(), "tracker"));
                 return std::make_unique<FlyPtTracker>();
             }
+            if ("replay" == trackerType)
+            {
+                Log("recording file is replayed as reference tracker");
+                TraceLoggingWriteStop(local, "GetTracker", TLPArg(trackerType.c_str(), "tracker"));
+                return std::make_unique<ReplayTracker>();
+            }
+            if ("synthetic" == trackerType)
+            {
+                Log("synthetic motion data is used as reference tracker");
+                TraceLoggingWriteStop(local, "GetTracker", TLPArg(trackerType.c_str(), "tracker"));
+                return std::make_unique<SyntheticTracker>();
+            }
             if ("controller" == trackerType)
             {
                 Log("motion controller is used as reference tracker");
@@ -41,7 +41,7 @@ namespace tracker
         std::shared_ptr<output::RecorderBase> m_Recorder{std::make_shared<output::NoRecorder>()};
         
       private:
-        virtual void ApplyFilters(XrPosef& trackerPose){};
+        virtual void ApplyFilters(XrPosef& trackerPose, XrTime time){};
         virtual void ApplyModifier(XrPosef& trackerPose){};
 
         bool m_PhysicalEnabled{false};
@@ -50,7 +50,6 @@ namespace tracker
     class TrackerBase : public ControllerBase
     {
       public:
-        ~TrackerBase() override;
         bool Init() override;
         virtual bool LazyInit(XrTime time);
         void ModifyFilterStrength(bool trans, bool increase, bool fast);
@@ -75,7 +74,7 @@ namespace tracker
         bool m_Calibrated{false};
        
       protected:
-        void ApplyFilters(XrPosef& pose) override;
+        void ApplyFilters(XrPosef& pose, XrTime time) override;
         void ApplyModifier(XrPosef& pose) override;
         bool CalibrateForward(XrSession session, XrTime time, float yawOffset);
         void SetForwardRotation(const XrPosef& pose) const;
@@ -90,8 +89,9 @@ namespace tracker
 
         float m_TransStrength{0.0f};
         float m_RotStrength{0.0f};
-        filter::FilterBase<XrVector3f>* m_TransFilter = nullptr;
-        filter::FilterBase<XrQuaternionf>* m_RotFilter = nullptr;
+        // actual filters are created in LoadFilters
+        filter::TransFilter m_TransFilter{};
+        filter::RotFilter m_RotFilter{};
 
         std::shared_ptr<modifier::TrackerModifier> m_TrackerModifier{};
     };
@@ -108,7 +108,7 @@ namespace tracker
 
     class CorManipulator;
 
-    class VirtualTracker : public TrackerBase
+    class VirtualTracker : public TrackerBase, public sampler::SampleSource
     {
       public:
         explicit VirtualTracker(const std::vector<utility::DofValue>& relevantValues);
@@ -127,8 +127,8 @@ namespace tracker
         bool ChangeRotation(float radian) override;
         void LogOffsetValues() const;
 
-        virtual utility::DataSource* GetSource();
-        virtual bool ReadSource(XrTime time, utility::Dof& dof) = 0;
+        utility::DataSource* GetSource() override;
+        bool ReadSource(XrTime time, utility::Dof& dof) override = 0;
 
       protected:
         void SetReferencePose(const XrPosef& pose) override;
@@ -192,7 +192,7 @@ namespace tracker
         };
     };
 
-    class FlyPtTracker final : public SixDofTracker
+    class FlyPtTracker : public SixDofTracker
     {
       public:
         FlyPtTracker()
@@ -206,6 +206,32 @@ namespace tracker
         XrPosef DataToPose(const utility::Dof& dof) override;
     };
 
+    // replays a recording file with the same data conventions as FlyPT Mover, used to compare filter settings
+    class ReplayTracker final : public FlyPtTracker
+    {
+      public:
+        bool Init() override;
+        bool LazyInit(XrTime time) override;
+        utility::DataSource* GetSource() override;
+        bool ReadSource(XrTime now, utility::Dof& dof) override;
+
+      private:
+        utility::Recording m_Recording;
+    };
+
+    // generates synthetic motion data with the same data conventions as FlyPT Mover, used to test sampler and filters
+    class SyntheticTracker final : public FlyPtTracker
+    {
+      public:
+        bool Init() override;
+        bool LazyInit(XrTime time) override;
+        utility::DataSource* GetSource() override;
+        bool ReadSource(XrTime now, utility::Dof& dof) override;
+
+      private:
+        utility::Synthetic m_Synthetic;
+    };
+
     class SrsTracker final : public SixDofTracker
     {
       public:
@@ -5,7 +5,6 @@
 #include <DirectXMath.h>
 #include <log.h>
 #include <util.h>
-#include "layer.h"
 #include "config.h"
 #include "output.h"
 
@@ -44,48 +43,68 @@ namespace utility
         return angles;
     }
 
-    AutoActivator::AutoActivator(const std::shared_ptr<input::InputHandler>& input)
+    // unused view slots are zero-initialized and would result in invalid quaternions
+    static bool IsUnused(const XrPosef& pose)
     {
-        m_Input = input;
-        GetConfig()->GetBool(Cfg::AutoActive, m_Activate);
-        GetConfig()->GetInt(Cfg::AutoActiveDelay, m_SecondsLeft);
-        GetConfig()->GetBool(Cfg::AutoActiveCountdown, m_Countdown);
+        const XrQuaternionf& q = pose.orientation;
+        return 0.f == q.x && 0.f == q.y && 0.f == q.z && 0.f == q.w;
+    }
 
-        Log("auto activation %s, delay: %d seconds, countdown %s",
-            m_Activate ? "on" : "off",
-            m_SecondsLeft,
-            m_Countdown ? "on" : "off");
+    XrPosef Interpolate(const XrPosef& from, const XrPosef& to, const float alpha)
+    {
+        XrPosef result;
+        StoreXrVector3(&result.position,
+                       XMVectorLerp(LoadXrVector3(from.position), LoadXrVector3(to.position), alpha));
+        StoreXrQuaternion(&result.orientation,
+                          XMQuaternionSlerp(LoadXrQuaternion(from.orientation), LoadXrQuaternion(to.orientation), alpha));
+        return result;
     }
-    void AutoActivator::ActivateIfNecessary(const XrTime time)
+
+    EyePoses Interpolate(const EyePoses& from, const EyePoses& to, const float alpha)
     {
-        if (m_Activate)
+        EyePoses result;
+        for (uint32_t i = 0; i < maxViews; i++)
         {
-            TraceLocalActivity(local);
-            TraceLoggingWriteStart(local, "AutoActivator::ActivateIfNecessary", TLArg(time, "Time"));
+            result[i] = IsUnused(from[i]) || IsUnused(to[i]) ? to[i] : Interpolate(from[i], to[i], alpha);
+        }
+        return result;
+    }
 
-            if (m_SecondsLeft <= 0)
-            {
-                m_Input->ToggleActive(time);
-                m_Activate = false;
-                TraceLoggingWriteStop(local,
-                                      "AutoActivator::ActivateIfNecessary",
-                                      TLArg(m_SecondsLeft, "No_Seconds_Left"));
-                return;
-            }
-            if (0 == m_ActivationTime)
-            {
-                m_ActivationTime = time + ++m_SecondsLeft * 1000000000ll;
-            }
-            const int currentlyLeft = static_cast<int>((m_ActivationTime - time) / 1000000000ll);
+    XrPosef Extrapolate(const XrPosef& base, const XrPosef& reference, const float factor)
+    {
+        XrPosef result;
+        const XMVECTOR position = LoadXrVector3(reference.position);
+        StoreXrVector3(&result.position,
+                       XMVectorAdd(position,
+                                   XMVectorScale(XMVectorSubtract(position, LoadXrVector3(base.position)), factor)));
 
-            if (m_Countdown && currentlyLeft < m_SecondsLeft)
-            {
-                output::AudioOut::CountDown(currentlyLeft);
-            }
-            m_SecondsLeft = currentlyLeft;
+        // scale rotation angle between base and reference
+        const XMVECTOR orientation = LoadXrQuaternion(reference.orientation);
+        const XMVECTOR difference =
+            XMQuaternionMultiply(XMQuaternionInverse(LoadXrQuaternion(base.orientation)), orientation);
+        XMVECTOR axis;
+        float angle;
+        XMQuaternionToAxisAngle(&axis, &angle, difference);
+        if (angle > floatPi)
+        {
+            // take shorter path
+            angle -= 2.f * floatPi;
+        }
+        const XMVECTOR rotation = std::abs(angle) > 1e-6f ? XMQuaternionRotationAxis(axis, angle * factor)
+                                                           : XMQuaternionIdentity();
+        StoreXrQuaternion(&result.orientation, XMQuaternionNormalize(XMQuaternionMultiply(orientation, rotation)));
+        return result;
+    }
 
-            TraceLoggingWriteStop(local, "AutoActivator::ActivateIfNecessary", TLArg(m_SecondsLeft, "Seconds_Left"));
+    EyePoses Extrapolate(const EyePoses& base, const EyePoses& reference, const float factor)
+    {
+        EyePoses result;
+        for (uint32_t i = 0; i < maxViews; i++)
+        {
+            result[i] = IsUnused(base[i]) || IsUnused(reference[i]) ? reference[i]
+                                                                      : Extrapolate(base[i], reference[i], factor);
         }
+        return result;
     }
 
     Mmf::Mmf()
@@ -102,11 +121,23 @@ namespace utility
                      __FUNCTION__,
                      static_cast<double>(m_Check) / 1000000.0);
         }
+        if (LARGE_INTEGER frequency; QueryPerformanceFrequency(&frequency))
+        {
+            m_Frequency = frequency.QuadPart;
+        }
     }
 
     Mmf::~Mmf()
     {
         Close();
+        if (m_SequencedReads > 0)
+        {
+            Log("mmf '%s': %llu sequenced reads, %llu retries, %llu stale reads",
+                m_Name.c_str(),
+                m_SequencedReads,
+                m_Retries,
+                m_StaleReads);
+        }
     }
 
     void Mmf::SetName(const std::string& name)
@@ -127,6 +158,8 @@ namespace utility
             m_View = MapViewOfFile(m_FileHandle, FILE_MAP_READ, 0, 0, 0);
             if (m_View != nullptr)
             {
+                MEMORY_BASIC_INFORMATION info{};
+                m_ViewSize = VirtualQuery(m_View, &info, sizeof(info)) ? info.RegionSize : 0;
                 m_LastRefresh = time;
                 m_ConnectionLost = false;
             }
@@ -171,7 +204,23 @@ namespace utility
         {
             try
             {
-                memcpy(buffer, m_View, size);
+                if (const bool sequenced = IsSequenced(size); sequenced != m_Sequenced)
+                {
+                    Log("mmf '%s' uses %s layout", m_Name.c_str(), sequenced ? "sequenced" : "legacy");
+                    m_Sequenced = sequenced;
+                }
+                if (m_Sequenced)
+                {
+                    if (!ReadSequenced(buffer, size))
+                    {
+                        TraceLoggingWriteStop(local, "Mmf::Read", TLArg(false, "Sequence"));
+                        return false;
+                    }
+                }
+                else
+                {
+                    memcpy(buffer, m_View, size);
+                }
             }
             catch (std::exception& e)
             {
@@ -188,6 +237,80 @@ namespace utility
         return false;
     }
 
+    bool Mmf::IsSequenced(const size_t size) const
+    {
+        if (m_ViewSize < sizeof(SequenceHeader))
+        {
+            return false;
+        }
+        const auto header = static_cast<const SequenceHeader*>(m_View);
+        return sequenceMagic == header->magic && sequenceVersion == header->version &&
+               sizeof(SequenceHeader) <= header->payloadOffset && header->payloadOffset % 8 == 0 &&
+               header->payloadOffset + size <= m_ViewSize;
+    }
+
+    bool Mmf::ReadSequenced(void* buffer, const size_t size)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Mmf::ReadSequenced");
+
+        const auto header = static_cast<SequenceHeader*>(m_View);
+        const auto payload = static_cast<const char*>(m_View) + header->payloadOffset;
+        const std::atomic_ref sequence(header->sequence);
+        const std::atomic_ref timestamp(header->timestamp);
+        m_SequencedReads++;
+        for (uint32_t attempt = 0; attempt < maxRetries; attempt++)
+        {
+            const uint64_t before = sequence.load(std::memory_order_acquire);
+            if (0 == (before & 1))
+            {
+                memcpy(buffer, payload, size);
+                const int64_t producerTime = timestamp.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before)
+                {
+                    LARGE_INTEGER now;
+                    QueryPerformanceCounter(&now);
+                    TraceLoggingWriteStop(
+                        local,
+                        "Mmf::ReadSequenced",
+                        TLArg(before, "Sequence"),
+                        TLArg(before != m_Sequence, "Updated"),
+                        TLArg(attempt, "Retries"),
+                        TLArg(m_Frequency > 0 ? static_cast<double>(now.QuadPart - producerTime) * 1000.0 /
+                                                    static_cast<double>(m_Frequency)
+                                              : 0.0,
+                              "ProducerAge"));
+                    m_Sequence = before;
+                    m_LastPayload.assign(static_cast<const char*>(buffer), static_cast<const char*>(buffer) + size);
+                    return true;
+                }
+            }
+            m_Retries++;
+            YieldProcessor();
+        }
+
+        // producer is stuck within a write or terminated while writing -> repeat last consistent payload
+        // instead of failing, which would make the sampler restart over and over
+        if (!m_TornReadLogged)
+        {
+            ErrorLog("%s: mmf '%s' is still being written after %u attempts, repeating previous data",
+                     __FUNCTION__,
+                     m_Name.c_str(),
+                     maxRetries);
+            m_TornReadLogged = true;
+        }
+        if (m_LastPayload.size() != size)
+        {
+            TraceLoggingWriteStop(local, "Mmf::ReadSequenced", TLArg(false, "Success"));
+            return false;
+        }
+        memcpy(buffer, m_LastPayload.data(), size);
+        m_StaleReads++;
+        TraceLoggingWriteStop(local, "Mmf::ReadSequenced", TLArg(true, "Stale"));
+        return true;
+    }
+
     void Mmf::Close()
     {
         TraceLocalActivity(local);
@@ -199,6 +322,7 @@ namespace utility
             UnmapViewOfFile(m_View);
         }
         m_View = nullptr;
+        m_ViewSize = 0;
         if (m_FileHandle)
         {
             CloseHandle(m_FileHandle);
@@ -208,6 +332,532 @@ namespace utility
         TraceLoggingWriteStop(local, "Mmf::Close");
     }
 
+    MmfWriter::~MmfWriter()
+    {
+        Close();
+    }
+
+    bool MmfWriter::Create(const std::string& name, const size_t size, const bool sequenced)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local,
+                               "MmfWriter::Create",
+                               TLArg(name.c_str(), "Name"),
+                               TLArg(size, "Size"),
+                               TLArg(sequenced, "Sequenced"));
+
+        Close();
+        m_Offset = sequenced ? sizeof(Mmf::SequenceHeader) : 0;
+        const size_t total = m_Offset + size;
+        m_FileHandle = CreateFileMapping(INVALID_HANDLE_VALUE,
+                                         nullptr,
+                                         PAGE_READWRITE,
+                                         static_cast<DWORD>(static_cast<uint64_t>(total) >> 32),
+                                         static_cast<DWORD>(total & 0xffffffff),
+                                         name.c_str());
+        if (m_FileHandle)
+        {
+            m_View = MapViewOfFile(m_FileHandle, FILE_MAP_ALL_ACCESS, 0, 0, total);
+        }
+        if (!m_View)
+        {
+            ErrorLog("%s: unable to create mmf '%s': %s", __FUNCTION__, name.c_str(), LastErrorMsg().c_str());
+            Close();
+            TraceLoggingWriteStop(local, "MmfWriter::Create", TLArg(false, "Success"));
+            return false;
+        }
+        m_Size = size;
+        if (sequenced)
+        {
+            const auto header = static_cast<Mmf::SequenceHeader*>(m_View);
+            header->version = Mmf::sequenceVersion;
+            header->payloadOffset = static_cast<uint32_t>(m_Offset);
+            header->sequence = 0;
+            header->timestamp = 0;
+            // readers detect the sequenced layout by the magic, so it is written last
+            std::atomic_ref(header->magic).store(Mmf::sequenceMagic, std::memory_order_release);
+        }
+
+        TraceLoggingWriteStop(local, "MmfWriter::Create", TLArg(true, "Success"));
+        return true;
+    }
+
+    void MmfWriter::Write(const void* buffer, const size_t size)
+    {
+        if (!m_View || size > m_Size)
+        {
+            return;
+        }
+        const auto payload = static_cast<char*>(m_View) + m_Offset;
+        if (0 == m_Offset)
+        {
+            memcpy(payload, buffer, size);
+            return;
+        }
+        const auto header = static_cast<Mmf::SequenceHeader*>(m_View);
+        const std::atomic_ref sequence(header->sequence);
+        const uint64_t current = sequence.load(std::memory_order_relaxed);
+        // odd sequence while payload and timestamp are written
+        sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(payload, buffer, size);
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        std::atomic_ref(header->timestamp).store(now.QuadPart, std::memory_order_relaxed);
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    void MmfWriter::Close()
+    {
+        if (m_View)
+        {
+            UnmapViewOfFile(m_View);
+        }
+        m_View = nullptr;
+        m_Size = 0;
+        if (m_FileHandle)
+        {
+            CloseHandle(m_FileHandle);
+        }
+        m_FileHandle = nullptr;
+    }
+
+    void Recording::SetFile(const std::filesystem::path& file)
+    {
+        std::unique_lock lock(m_RecordingLock);
+        m_File = file;
+        m_Times.clear();
+        m_Values.clear();
+        m_Start = 0;
+    }
+
+    bool Recording::Open(const int64_t time)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Recording::Open", TLArg(time, "Time"));
+
+        std::unique_lock lock(m_RecordingLock);
+        const bool success = !m_Values.empty() || Load();
+
+        TraceLoggingWriteStop(local, "Recording::Open", TLArg(success, "Success"));
+        return success;
+    }
+
+    bool Recording::Read(void* buffer, const size_t size, const int64_t time)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Recording::Read", TLArg(time, "Time"));
+
+        std::unique_lock lock(m_RecordingLock);
+        if (m_Values.empty() || sizeof(Dof) != size)
+        {
+            TraceLoggingWriteStop(local, "Recording::Read", TLArg(false, "Success"));
+            return false;
+        }
+
+        // replay in real time, independent of the time base used by the caller (xr or sampler time)
+        const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+        if (0 == m_Start)
+        {
+            m_Start = now;
+        }
+        const int64_t elapsed = (now - m_Start) % (m_Times.back() + 1);
+
+        const size_t next = std::upper_bound(m_Times.begin(), m_Times.end(), elapsed) - m_Times.begin();
+        Dof dof{};
+        if (next >= m_Times.size())
+        {
+            dof = m_Values.back();
+        }
+        else
+        {
+            const Dof& from = m_Values[next - 1];
+            const Dof& to = m_Values[next];
+            const float alpha = static_cast<float>(elapsed - m_Times[next - 1]) /
+                                static_cast<float>(m_Times[next] - m_Times[next - 1]);
+            for (int i = 0; i < 6; i++)
+            {
+                float delta = to.data[i] - from.data[i];
+                if (i >= yaw)
+                {
+                    // interpolate angles (in degrees) along the shorter arc
+                    delta = fmod(delta + 540.0f, 360.0f) - 180.0f;
+                }
+                dof.data[i] = from.data[i] + alpha * delta;
+            }
+        }
+        memcpy(buffer, &dof, size);
+
+        TraceLoggingWriteStop(local, "Recording::Read", TLArg(true, "Success"), TLArg(elapsed, "Elapsed"));
+        return true;
+    }
+
+    bool Recording::Load()
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Recording::Load", TLArg(m_File.string().c_str(), "File"));
+
+        std::vector<Dof> filtered;
+        if (!Parse(m_File, m_Times, m_Values, filtered))
+        {
+            TraceLoggingWriteStop(local, "Recording::Load", TLArg(false, "Success"));
+            return false;
+        }
+        Log("replaying %u samples (%.3f s) from recording file: %s",
+            static_cast<uint32_t>(m_Values.size()),
+            static_cast<double>(m_Times.back()) / 1000000000.0,
+            m_File.string().c_str());
+
+        TraceLoggingWriteStop(local,
+                              "Recording::Load",
+                              TLArg(true, "Success"),
+                              TLArg(static_cast<uint32_t>(m_Values.size()), "Samples"));
+        return true;
+    }
+
+    bool Recording::Parse(const std::filesystem::path& file,
+                          std::vector<int64_t>& times,
+                          std::vector<Dof>& unfiltered,
+                          std::vector<Dof>& filtered)
+    {
+        std::ifstream stream(file);
+        if (!stream.is_open())
+        {
+            ErrorLog("%s: unable to open recording file: %s", __FUNCTION__, file.string().c_str());
+            return false;
+        }
+
+        // skip headline
+        std::string line;
+        std::getline(stream, line);
+
+        int64_t first{0};
+        while (std::getline(stream, line))
+        {
+            std::vector<std::string> fields;
+            std::stringstream lineStream(line);
+            std::string field;
+            while (std::getline(lineStream, field, ';'))
+            {
+                fields.push_back(field);
+            }
+            // elapsed, time, frame time and three columns (unfiltered, filtered, modified) per degree of freedom
+            if (fields.size() < 21)
+            {
+                continue;
+            }
+            try
+            {
+                const int64_t time = std::stoll(fields[1]);
+                Dof input{}, output{};
+                for (int i = 0; i < 6; i++)
+                {
+                    input.data[i] = std::stof(fields[3 + 3 * i]);
+                    output.data[i] = std::stof(fields[4 + 3 * i]);
+                }
+                if (times.empty())
+                {
+                    first = time;
+                }
+                else if (time - first <= times.back())
+                {
+                    // skip samples written without time progression
+                    continue;
+                }
+                times.push_back(time - first);
+                unfiltered.push_back(input);
+                filtered.push_back(output);
+            }
+            catch (const std::exception& e)
+            {
+                ErrorLog("%s: unable to parse line '%s': %s", __FUNCTION__, line.c_str(), e.what());
+            }
+        }
+        if (unfiltered.empty())
+        {
+            ErrorLog("%s: no samples found in recording file: %s", __FUNCTION__, file.string().c_str());
+            return false;
+        }
+        return true;
+    }
+
+    void Synthetic::Configure(const std::string& signal, const float rate, const float noise, const float dropouts)
+    {
+        std::unique_lock lock(m_SyntheticLock);
+        if ("sweep" == signal)
+        {
+            m_Signal = Sweep;
+        }
+        else if ("step" == signal)
+        {
+            m_Signal = Step;
+        }
+        else if ("noise" == signal)
+        {
+            m_Signal = Noise;
+        }
+        else
+        {
+            if ("mixed" != signal)
+            {
+                ErrorLog("%s: unknown synthetic signal: %s, using mixed", __FUNCTION__, signal.c_str());
+            }
+            m_Signal = Mixed;
+        }
+        m_UpdateInterval = static_cast<int64_t>(1000000000.0 / std::max(rate, 1.f));
+        if (noise < 0.f)
+        {
+            ErrorLog("%s: invalid synthetic noise: %f, using 0.0", __FUNCTION__, noise);
+        }
+        m_Noise = std::max(noise, 0.f);
+        // probability to start a dropout on an update
+        const double probability = std::max(dropouts, 0.f) / 60.0 * static_cast<double>(m_UpdateInterval) / 1e9;
+        if (probability > 1.0)
+        {
+            ErrorLog("%s: synthetic dropouts (%.1f per minute) exceed update rate, starting dropout on every update",
+                     __FUNCTION__,
+                     dropouts);
+        }
+        m_DropoutProbability = std::clamp(probability, 0.0, 1.0);
+        m_Start = 0;
+        Log("synthetic motion data: signal = %s, update rate = %.1f Hz, noise = %.3f, dropouts = %.1f per minute",
+            signal.c_str(),
+            1e9 / static_cast<double>(m_UpdateInterval),
+            m_Noise,
+            dropouts);
+    }
+
+    bool Synthetic::Open(int64_t time)
+    {
+        return true;
+    }
+
+    bool Synthetic::Read(void* buffer, const size_t size, const int64_t time)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "Synthetic::Read", TLArg(time, "Time"));
+
+        if (sizeof(Dof) != size)
+        {
+            TraceLoggingWriteStop(local, "Synthetic::Read", TLArg(false, "Success"));
+            return false;
+        }
+
+        // generate in real time, independent of the time base used by the caller (xr or sampler time)
+        std::unique_lock lock(m_SyntheticLock);
+        const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+        if (0 == m_Start)
+        {
+            m_Start = now;
+            m_LastUpdate = now - m_UpdateInterval;
+        }
+        if (now >= m_DropoutEnd && now - m_LastUpdate >= m_UpdateInterval)
+        {
+            m_LastUpdate = now - (now - m_LastUpdate) % m_UpdateInterval;
+            if (std::bernoulli_distribution(m_DropoutProbability)(m_Generator))
+            {
+                m_DropoutEnd = now + dropoutDuration;
+                TraceLoggingWriteTagged(local, "Synthetic::Read", TLArg(true, "Dropout"));
+            }
+            const double elapsed = static_cast<double>(m_LastUpdate - m_Start) / 1e9;
+            for (size_t i = 0; i < 6; i++)
+            {
+                m_Current.data[i] = Generate(i, elapsed);
+            }
+            // a standard deviation of zero is invalid for the distribution
+            if (m_Noise > 0.f)
+            {
+                std::normal_distribution<float> noise(0.f, m_Noise);
+                for (size_t i = 0; i < 6; i++)
+                {
+                    m_Current.data[i] += amplitude[i] * noise(m_Generator);
+                }
+            }
+        }
+        memcpy(buffer, &m_Current, size);
+
+        TraceLoggingWriteStop(local, "Synthetic::Read", TLArg(true, "Success"));
+        return true;
+    }
+
+    float Synthetic::Generate(const size_t index, const double elapsed) const
+    {
+        if (Noise == m_Signal)
+        {
+            return 0.f;
+        }
+        // shift dofs against each other to avoid identical motion on all axes
+        const double shifted = elapsed + static_cast<double>(index) * 0.7;
+        const bool stepPhase = std::fmod(elapsed, sweepDuration + stepDuration) >= sweepDuration;
+        if (Step == m_Signal || (Mixed == m_Signal && stepPhase))
+        {
+            // steps between +/- amplitude once per second
+            return std::fmod(shifted, 2.0) < 1.0 ? amplitude[index] : -amplitude[index];
+        }
+        // phase of exponential chirp from min to max frequency within sweep duration
+        const double ratio = maxFrequency / minFrequency;
+        const double t = std::fmod(shifted, sweepDuration);
+        const double phase =
+            2.0 * M_PI * minFrequency * sweepDuration / std::log(ratio) * (std::pow(ratio, t / sweepDuration) - 1.0);
+        return amplitude[index] * static_cast<float>(std::sin(phase));
+    }
+
+    PipelineTimer::Scope::Scope(const Stage stage) : m_Stage(stage)
+    {
+        if (GetPipelineTimer()->IsEnabled())
+        {
+            m_Start = std::chrono::steady_clock::now();
+        }
+    }
+
+    PipelineTimer::Scope::~Scope()
+    {
+        if (GetPipelineTimer()->IsEnabled())
+        {
+            GetPipelineTimer()->Add(
+                m_Stage,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start)
+                    .count());
+        }
+    }
+
+    void PipelineTimer::SetInterval(const XrTime interval)
+    {
+        m_Interval = std::max(interval, XrTime{0});
+        if (m_Interval > 0)
+        {
+            Log("pose pipeline timing is logged every %.3f s", static_cast<double>(m_Interval) / 1000000000.0);
+        }
+    }
+
+    bool PipelineTimer::IsEnabled() const
+    {
+        return m_Interval > 0;
+    }
+
+    void PipelineTimer::Add(const Stage stage, const int64_t duration)
+    {
+        const auto value = static_cast<uint64_t>(std::max(duration, int64_t{0}));
+        m_Calls[stage].fetch_add(1, std::memory_order_relaxed);
+        m_Total[stage].fetch_add(value, std::memory_order_relaxed);
+        uint64_t max = m_Max[stage].load(std::memory_order_relaxed);
+        while (value > max && !m_Max[stage].compare_exchange_weak(max, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void PipelineTimer::EndFrame(const XrTime time)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+        m_Frames++;
+        if (time - m_LastLog >= m_Interval)
+        {
+            // first interval is only used to start the measurement
+            if (m_LastLog > 0)
+            {
+                LogStatistics();
+            }
+            for (uint32_t i = 0; i < StageCount; i++)
+            {
+                m_Calls[i].store(0, std::memory_order_relaxed);
+                m_Total[i].store(0, std::memory_order_relaxed);
+                m_Max[i].store(0, std::memory_order_relaxed);
+            }
+            m_Frames = 0;
+            m_LastLog = time;
+        }
+    }
+
+    void PipelineTimer::LogStatistics()
+    {
+        std::string stages;
+        uint64_t frameTotal{0};
+        for (uint32_t i = 0; i < StageCount; i++)
+        {
+            const uint64_t calls = m_Calls[i].load(std::memory_order_relaxed);
+            const uint64_t total = m_Total[i].load(std::memory_order_relaxed);
+            frameTotal += total;
+            stages += fmt::format("{}{}: {} calls, avg {} ns, max {} ns, {} ns/frame",
+                                  i > 0 ? "; " : "",
+                                  m_StageNames[i],
+                                  calls,
+                                  calls > 0 ? total / calls : 0,
+                                  m_Max[i].load(std::memory_order_relaxed),
+                                  m_Frames > 0 ? total / m_Frames : 0);
+        }
+        Log("pose pipeline timing over %llu frames: %llu ns/frame, %s",
+            m_Frames,
+            m_Frames > 0 ? frameTotal / m_Frames : 0,
+            stages.c_str());
+    }
+
+    std::unique_ptr<PipelineTimer> g_PipelineTimer = nullptr;
+
+    PipelineTimer* GetPipelineTimer()
+    {
+        if (!g_PipelineTimer)
+        {
+            g_PipelineTimer = std::make_unique<PipelineTimer>();
+        }
+        return g_PipelineTimer.get();
+    }
+
+    void TimeConverter::Init(const XrInstance instance, const PFN_xrGetInstanceProcAddr getInstanceProcAddr)
+    {
+        TraceLocalActivity(local);
+        TraceLoggingWriteStart(local, "TimeConverter::Init", TLPArg(instance, "Instance"));
+
+        m_Instance = instance;
+        m_ConvertTime = nullptr;
+        if (LARGE_INTEGER frequency; QueryPerformanceFrequency(&frequency))
+        {
+            m_Frequency = frequency.QuadPart;
+        }
+        if (!getInstanceProcAddr ||
+            XR_FAILED(getInstanceProcAddr(instance,
+                                          "xrConvertTimeToWin32PerformanceCounterKHR",
+                                          reinterpret_cast<PFN_xrVoidFunction*>(&m_ConvertTime))))
+        {
+            m_ConvertTime = nullptr;
+        }
+        Log("conversion of xr time to performance counter is %s", IsAvailable() ? "available" : "not available");
+
+        TraceLoggingWriteStop(local, "TimeConverter::Init", TLArg(IsAvailable(), "Available"));
+    }
+
+    bool TimeConverter::IsAvailable() const
+    {
+        return m_ConvertTime && m_Frequency > 0;
+    }
+
+    bool TimeConverter::ToSteadyClock(const XrTime time, int64_t& steadyTime) const
+    {
+        LARGE_INTEGER counter;
+        if (!IsAvailable() || XR_FAILED(m_ConvertTime(m_Instance, time, &counter)))
+        {
+            return false;
+        }
+        // same arithmetic as steady_clock::now(), avoiding overflow of counter * 1e9
+        constexpr int64_t nanosecondsPerSecond{1000000000};
+        const int64_t whole = counter.QuadPart / m_Frequency, part = counter.QuadPart % m_Frequency;
+        steadyTime = whole * nanosecondsPerSecond + part * nanosecondsPerSecond / m_Frequency;
+        return true;
+    }
+
+    std::unique_ptr<TimeConverter> g_TimeConverter = nullptr;
+
+    TimeConverter* GetTimeConverter()
+    {
+        if (!g_TimeConverter)
+        {
+            g_TimeConverter = std::make_unique<TimeConverter>();
+        }
+        return g_TimeConverter.get();
+    }
+
     std::string LastErrorMsg()
     {
         if (const DWORD error = GetLastError())
@@ -25,26 +25,262 @@ namespace utility
         pitch
     };
 
+    // inline storage for eye poses, sufficient for quad view configurations
+    constexpr uint32_t maxViews{4};
+    typedef std::array<XrPosef, maxViews> EyePoses;
+
     XrVector3f ToEulerAngles(XrQuaternionf q);
 
-    class AutoActivator
+    // linear interpolation of position and spherical interpolation of orientation, alpha = 0 returns from
+    XrPosef Interpolate(const XrPosef& from, const XrPosef& to, float alpha);
+    EyePoses Interpolate(const EyePoses& from, const EyePoses& to, float alpha);
+
+    // continue linear and angular velocity from base to reference, factor = 1 adds the full difference once more
+    XrPosef Extrapolate(const XrPosef& base, const XrPosef& reference, float factor);
+    EyePoses Extrapolate(const EyePoses& base, const EyePoses& reference, float factor);
+
+    // cache entries surrounding a requested time
+    // the base entry precedes the lower one and is used to determine the rate of change
+    template <typename Sample>
+    struct Neighborhood
+    {
+        std::optional<std::pair<XrTime, Sample>> lower{}, upper{}, lowerBase{};
+    };
+
+    // fixed capacity, time-ordered ring buffer
+    // writers are serialized by a spin lock, readers are lock-free and retry if a write occurred while reading
+    template <typename Sample>
+    class RingBuffer
     {
       public:
-        explicit AutoActivator(const std::shared_ptr<input::InputHandler>& input);
-        void ActivateIfNecessary(XrTime time);
+        typedef std::pair<XrTime, Sample> Entry;
+
+        explicit RingBuffer(const size_t capacity) : m_Entries(capacity), m_Capacity(capacity)
+        {
+            static_assert(std::is_trivially_copyable_v<Sample>, "ring buffer requires trivially copyable samples");
+        }
+
+        // returns false if the sample was not stored
+        bool Insert(const XrTime time, const Sample& sample, const bool override, bool& existing)
+        {
+            BeginWrite();
+            size_t pos = LowerBound(time);
+            existing = pos < m_Count && At(pos).first == time;
+            if (existing)
+            {
+                if (override)
+                {
+                    At(pos).second = sample;
+                }
+                EndWrite();
+                return override;
+            }
+            if (m_Count == m_Capacity)
+            {
+                if (0 == pos)
+                {
+                    // older than every entry in a full buffer
+                    EndWrite();
+                    return false;
+                }
+                // drop oldest entry
+                m_Head = (m_Head + 1) % m_Capacity;
+                --m_Count;
+                --pos;
+            }
+            for (size_t i = m_Count; i > pos; --i)
+            {
+                At(i) = At(i - 1);
+            }
+            At(pos) = {time, sample};
+            ++m_Count;
+            EndWrite();
+            return true;
+        }
+
+        // determine last entry before and first entry at or after given time
+        // the base entry is up to baseDistance entries before the lower one
+        void Bracket(const XrTime time, const size_t baseDistance, Neighborhood<Sample>& result) const
+        {
+            for (uint32_t retry = 0; retry < maxReadRetries; retry++)
+            {
+                const uint32_t sequence = m_Sequence.load(std::memory_order_acquire);
+                if (!(sequence & 1))
+                {
+                    Collect(time, baseDistance, result);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (sequence == m_Sequence.load(std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+                }
+                m_ReadRetries.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::yield();
+            }
+            // writers keep interfering -> read while holding the write lock to guarantee progress
+            Lock();
+            Collect(time, baseDistance, result);
+            m_WriteLock.clear(std::memory_order_release);
+            m_LockedReads.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // number of lookups that had to fall back to locking
+        [[nodiscard]] uint64_t GetLockedReads() const
+        {
+            return m_LockedReads.load(std::memory_order_relaxed);
+        }
+
+        // number of lookup attempts repeated due to a concurrent write
+        [[nodiscard]] uint64_t GetReadRetries() const
+        {
+            return m_ReadRetries.load(std::memory_order_relaxed);
+        }
+
+        // number of lock acquisitions (by writers or locked reads) that had to wait for another holder
+        [[nodiscard]] uint64_t GetLockWaits() const
+        {
+            return m_LockWaits.load(std::memory_order_relaxed);
+        }
+
+        void Clear()
+        {
+            BeginWrite();
+            m_Head = 0;
+            m_Count = 0;
+            EndWrite();
+        }
+
+        // remove entries older than the last one preceding given time, returns time of the oldest remaining entry
+        std::optional<XrTime> EraseBefore(const XrTime time)
+        {
+            BeginWrite();
+            std::optional<XrTime> erased{};
+            if (const size_t pos = LowerBound(time); 1 < pos && pos <= m_Count)
+            {
+                m_Head = (m_Head + pos - 1) % m_Capacity;
+                m_Count -= pos - 1;
+                erased = At(0).first;
+            }
+            EndWrite();
+            return erased;
+        }
 
       private:
-        std::shared_ptr<input::InputHandler> m_Input;
-        bool m_Activate{false};
-        bool m_Countdown{false};
-        int m_SecondsLeft{0};
-        XrTime m_ActivationTime{0};
+        static constexpr uint32_t maxReadRetries{1000};
+
+        void Lock() const
+        {
+            if (!m_WriteLock.test_and_set(std::memory_order_acquire))
+            {
+                return;
+            }
+            m_LockWaits.fetch_add(1, std::memory_order_relaxed);
+            while (m_WriteLock.test_and_set(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        void BeginWrite()
+        {
+            Lock();
+            m_Sequence.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        void EndWrite()
+        {
+            m_Sequence.fetch_add(1, std::memory_order_release);
+            m_WriteLock.clear(std::memory_order_release);
+        }
+
+        void Collect(const XrTime time, const size_t baseDistance, Neighborhood<Sample>& result) const
+        {
+            result = {};
+            const size_t pos = LowerBound(time), count = std::min(m_Count, m_Capacity);
+            if (pos < count)
+            {
+                result.upper = At(pos);
+            }
+            if (0 < pos)
+            {
+                result.lower = At(pos - 1);
+                if (0 < baseDistance && 1 < pos)
+                {
+                    result.lowerBase = At(pos - 1 - std::min(baseDistance, pos - 1));
+                }
+            }
+        }
+
+        [[nodiscard]] Entry& At(const size_t index)
+        {
+            return m_Entries[(m_Head + index) % m_Capacity];
+        }
+
+        [[nodiscard]] const Entry& At(const size_t index) const
+        {
+            return m_Entries[(m_Head + index) % m_Capacity];
+        }
+
+        // binary search for first entry not earlier than given time
+        [[nodiscard]] size_t LowerBound(const XrTime time) const
+        {
+            size_t first = 0, count = std::min(m_Count, m_Capacity);
+            while (0 < count)
+            {
+                const size_t step = count / 2;
+                if (At(first + step).first < time)
+                {
+                    first += step + 1;
+                    count -= step + 1;
+                }
+                else
+                {
+                    count = step;
+                }
+            }
+            return first;
+        }
+
+        std::vector<Entry> m_Entries;
+        const size_t m_Capacity;
+        size_t m_Head{0};
+        size_t m_Count{0};
+        std::atomic<uint32_t> m_Sequence{0};
+        mutable std::atomic_flag m_WriteLock = ATOMIC_FLAG_INIT;
+        mutable std::atomic<uint64_t> m_LockedReads{0};
+        mutable std::atomic<uint64_t> m_ReadRetries{0};
+        mutable std::atomic<uint64_t> m_LockWaits{0};
     };
 
     template <typename Sample>
     class Cache
     {
       public:
+        typedef std::pair<XrTime, Sample> Entry;
+
+        enum Match
+        {
+            Exact = 0,
+            Interpolated,
+            Extrapolated,
+            Later,
+            Earlier,
+            Estimated,
+            Fallback,
+            MatchCount
+        };
+
+        // upper limits of the buckets for the time difference between requested and matched sample
+        static constexpr std::array<XrTime, 9> skewLimits{
+            0, 100000, 1000000, 2000000, 5000000, 10000000, 20000000, 50000000, 100000000};
+
+        struct Statistics
+        {
+            std::array<uint64_t, MatchCount> matches{};
+            std::array<uint64_t, skewLimits.size() + 1> skew{};
+        };
+
         explicit Cache(const std::string& type, Sample fallback) : m_Fallback(fallback), m_SampleType(type){};
 
         void SetTolerance(const XrTime tolerance)
@@ -58,12 +294,88 @@ namespace utility
             TraceLoggingWriteStop(local, "Cache::SetTolerance");
         }
 
+        // interpolate between preceding and succeeding sample instead of selecting one of them
+        void UseInterpolation(const bool enable)
+        {
+            openxr_api_layer::log::Log("%s cache interpolation is %s", m_SampleType.c_str(), enable ? "on" : "off");
+            m_Interpolate = enable;
+        }
+
+        // expected time between two cache entries, limits the gap that is bridged by interpolation
+        void SetFramePeriod(const XrTime period)
+        {
+            m_FramePeriod.store(period, std::memory_order_relaxed);
+        }
+
+        // estimate samples outside of cached time range up to given limit, 0 = off
+        void SetExtrapolationLimit(const XrTime limit)
+        {
+            openxr_api_layer::log::Log("%s cache extrapolation limit is set to %.3f ms",
+                                       m_SampleType.c_str(),
+                                       limit / 1000000.0);
+            m_ExtrapolationLimit = std::max(limit, XrTime{0});
+        }
+
+        // needs to be called before the cache is used and after the tolerance is set
+        // the capacity covers the tolerance at the maximum expected frame rate
+        void UseRingBuffer(const bool enable)
+        {
+            using namespace openxr_api_layer::log;
+            TraceLocalActivity(local);
+            TraceLoggingWriteStart(local,
+                                   "Cache::UseRingBuffer",
+                                   TLArg(m_SampleType.c_str(), "Type"),
+                                   TLArg(enable, "Enable"));
+
+            if constexpr (std::is_trivially_copyable_v<Sample>)
+            {
+                if (enable && !m_Ring)
+                {
+                    const size_t framesInTolerance = static_cast<size_t>(m_Tolerance / minFramePeriod) + 1;
+                    const size_t capacity =
+                        std::clamp(samplesPerFrame * framesInTolerance, minRingCapacity, maxRingCapacity);
+                    m_Ring = std::make_unique<RingBuffer<Sample>>(capacity);
+                    Log("%s cache ring buffer capacity: %llu", m_SampleType.c_str(), static_cast<uint64_t>(capacity));
+                }
+                else if (!enable)
+                {
+                    m_Ring.reset();
+                }
+                Log("%s cache uses %s", m_SampleType.c_str(), m_Ring ? "ring buffer" : "map");
+            }
+            else if (enable)
+            {
+                ErrorLog("%s: ring buffer not supported for %s cache, using map",
+                         __FUNCTION__,
+                         m_SampleType.c_str());
+            }
+
+            TraceLoggingWriteStop(local, "Cache::UseRingBuffer", TLArg(!!m_Ring, "RingBuffer"));
+        }
+
         void AddSample(XrTime time, Sample sample, const bool override)
         {
             using namespace openxr_api_layer::log;
             TraceLocalActivity(local);
             TraceLoggingWriteStart(local, "Cache::AddSample", TLArg(m_SampleType.c_str(), "Type"), TLArg(time, "Time"));
 
+            if constexpr (std::is_trivially_copyable_v<Sample>)
+            {
+                if (m_Ring)
+                {
+                    bool existing;
+                    if (!m_Ring->Insert(time, sample, override, existing))
+                    {
+                        DebugLog("AddSample(%s) at %u: omitted", m_SampleType.c_str(), time);
+                        TraceLoggingWriteStop(local, "Cache::AddSample", TLArg(true, "Omitted"));
+                        return;
+                    }
+                    DebugLog("AddSample(%s) at %u: %s", m_SampleType.c_str(), time, existing ? "overriden" : "inserted");
+                    TraceLoggingWriteStop(local, "Cache::AddSample", TLArg(existing, "Override"));
+                    return;
+                }
+            }
+
             std::unique_lock lock(m_CacheLock);
             if (m_Cache.contains(time))
             {
@@ -90,76 +402,144 @@ namespace utility
             TraceLocalActivity(local);
             TraceLoggingWriteStart(local, "Cache::GetSample", TLArg(m_SampleType.c_str(), "Type"), TLArg(time, "Time"));
 
-            std::unique_lock lock(m_CacheLock);
+            Neighborhood<Sample> neighborhood;
+            Bracket(time, neighborhood);
+            const auto& [lower, upper, lowerBase] = neighborhood;
 
-            auto it = m_Cache.lower_bound(time);
-            const bool itIsEnd = m_Cache.end() == it;
-            if (!itIsEnd)
+            if (upper)
             {
-                if (it->first == time)
+                if (upper->first == time)
                 {
                     // exact entry found
                     TraceLoggingWriteStop(local,
                                           "Cache::GetSample",
                                           TLArg(m_SampleType.c_str(), "Type"),
                                           TLArg("Exact", "Match"),
-                                          TLArg(it->first, "Time"));
+                                          TLArg(upper->first, "Time"));
 
                     DebugLog("GetSample(%s) at %u: exact match found", m_SampleType.c_str(), time);
 
-                    return it->second;
+                    Count(Exact, 0);
+                    return upper->second;
                 }
-                else if (it->first <= time + m_Tolerance)
+                else if (m_Interpolate && lower)
+                {
+                    if (upper->first - lower->first <= MaxInterpolationGap())
+                    {
+                        // interpolate between surrounding entries
+                        const float alpha =
+                            static_cast<float>(time - lower->first) / static_cast<float>(upper->first - lower->first);
+                        TraceLoggingWriteStop(local,
+                                              "Cache::GetSample",
+                                              TLArg(m_SampleType.c_str(), "Type"),
+                                              TLArg("Interpolated", "Match"),
+                                              TLArg(lower->first, "Earlier"),
+                                              TLArg(upper->first, "Later"),
+                                              TLArg(alpha, "Alpha"));
+                        DebugLog("GetSample(%s) at %u: interpolated between %u and %u, alpha: %f",
+                                 m_SampleType.c_str(),
+                                 time,
+                                 lower->first,
+                                 upper->first,
+                                 alpha);
+
+                        Count(Interpolated, std::min(time - lower->first, upper->first - time));
+                        return Interpolate(lower->second, upper->second, alpha);
+                    }
+
+                    // surrounding entries are too far apart for interpolation -> use the nearer one
+                    const bool useLower = time - lower->first < upper->first - time;
+                    const Entry& nearest = useLower ? *lower : *upper;
+                    if (std::abs(time - nearest.first) <= m_Tolerance)
+                    {
+                        TraceLoggingWriteStop(local,
+                                              "Cache::GetSample",
+                                              TLArg(m_SampleType.c_str(), "Type"),
+                                              TLArg(useLower ? "Earlier" : "Later", "Match"),
+                                              TLArg(nearest.first, "Time"),
+                                              TLArg(upper->first - lower->first, "Gap"));
+                        DebugLog("GetSample(%s) at %u: gap too large for interpolation, nearest match: %u",
+                                 m_SampleType.c_str(),
+                                 time,
+                                 nearest.first);
+
+                        Count(useLower ? Earlier : Later, std::abs(time - nearest.first));
+                        return nearest.second;
+                    }
+                }
+                else if (upper->first <= time + m_Tolerance)
                 {
                     // succeeding entry is within tolerance
                     TraceLoggingWriteStop(local,
                                           "Cache::GetSample",
                                           TLArg(m_SampleType.c_str(), "Type"),
                                           TLArg("Later", "Match"),
-                                          TLArg(it->first, "Time"));
-                    DebugLog("GetSample(%s) at %u: later match found: %u", m_SampleType.c_str(), time, it->first);
+                                          TLArg(upper->first, "Time"));
+                    DebugLog("GetSample(%s) at %u: later match found: %u", m_SampleType.c_str(), time, upper->first);
 
-                    return it->second;
+                    Count(Later, upper->first - time);
+                    return upper->second;
                 }
             }
-            const bool itIsBegin = m_Cache.begin() == it;
-            if (!itIsBegin)
+            if (!upper && lower && lowerBase && m_ExtrapolationLimit > 0 &&
+                lower->first - lowerBase->first <= m_ExtrapolationLimit)
+            {
+                // requested time is newer than any entry -> extrapolate from the two newest entries
+                // limit extrapolation to keep estimation reasonably reliable
+                const XrTime horizon = std::min(time - lower->first, m_ExtrapolationLimit);
+                const float factor = static_cast<float>(horizon) / static_cast<float>(lower->first - lowerBase->first);
+                TraceLoggingWriteStop(local,
+                                      "Cache::GetSample",
+                                      TLArg(m_SampleType.c_str(), "Type"),
+                                      TLArg("Extrapolated", "Match"),
+                                      TLArg(lower->first, "Reference"),
+                                      TLArg(lowerBase->first, "Base"),
+                                      TLArg(factor, "Factor"));
+                DebugLog("GetSample(%s) at %u: extrapolated from %u and %u, factor: %f",
+                         m_SampleType.c_str(),
+                         time,
+                         lowerBase->first,
+                         lower->first,
+                         factor);
+
+                Count(Extrapolated, time - lower->first);
+                return Extrapolate(lowerBase->second, lower->second, factor);
+            }
+            if (lower)
             {
-                auto lowerIt = it;
-                --lowerIt;
-                if (lowerIt->first >= time - m_Tolerance)
+                if (lower->first >= time - m_Tolerance)
                 {
                     // preceding entry is within tolerance
                     TraceLoggingWriteStop(local,
                                           "Cache::GetSample",
                                           TLArg(m_SampleType.c_str(), "Type"),
                                           TLArg("Earlier", "Match"),
-                                          TLArg(lowerIt->first, "Time"));
-                    DebugLog("GetSample(%s) at %u: earlier match found: %u", m_SampleType.c_str(), time, lowerIt->first);
+                                          TLArg(lower->first, "Time"));
+                    DebugLog("GetSample(%s) at %u: earlier match found: %u", m_SampleType.c_str(), time, lower->first);
 
-                    return lowerIt->second;
+                    Count(Earlier, time - lower->first);
+                    return lower->second;
                 }
             }
             ErrorLog("GetSample(%s) unable to find sample %u+-%.3fms",
                      m_SampleType.c_str(),
                      time,
                      m_Tolerance / 1000000.0);
-            if (!itIsEnd)
+            if (upper)
             {
-                if (!itIsBegin)
+                if (lower)
                 {
-                    auto lowerIt = it;
-                    --lowerIt;
                     // both entries are valid -> select better match
-                    auto returnIt = (time - lowerIt->first < it->first - time ? lowerIt : it);
+                    const Entry& match = (time - lower->first < upper->first - time ? *lower : *upper);
                     TraceLoggingWriteStop(local,
                                           "Cache::GetSample",
                                           TLArg(m_SampleType.c_str(), "Type"),
                                           TLArg("Estimated Both", "Match"),
-                                          TLArg(it->first, "Time"));
-                    ErrorLog("GetSample(%s) at %u: using best match: %u ", m_SampleType.c_str(), time, returnIt->first);
+                                          TLArg(match.first, "Time"));
+                    ErrorLog("GetSample(%s) at %u: using best match: %u ", m_SampleType.c_str(), time, match.first);
 
-                    return returnIt->second;
+                    Count(Estimated, std::abs(time - match.first));
+                    return match.second;
                 }
                 // higher entry is first in cache -> use it
 
@@ -167,22 +547,22 @@ namespace utility
                                       "Cache::GetSample",
                                       TLArg(m_SampleType.c_str(), "Type"),
                                       TLArg("Estimated Later", "Match"),
-                                      TLArg(it->first, "Time"));
-                ErrorLog("GetSample(%s) at %u: using best match: t = %u ", m_SampleType.c_str(), time, it->first);
-                return it->second;
+                                      TLArg(upper->first, "Time"));
+                ErrorLog("GetSample(%s) at %u: using best match: t = %u ", m_SampleType.c_str(), time, upper->first);
+                Count(Estimated, upper->first - time);
+                return upper->second;
             }
-            if (!itIsBegin)
+            if (lower)
             {
-                auto lowerIt = it;
-                --lowerIt;
                 // lower entry is last in cache-> use it
-                ErrorLog("GetSample(%s) at %u: using best match: t = %u ", m_SampleType.c_str(), time, lowerIt->first);
+                ErrorLog("GetSample(%s) at %u: using best match: t = %u ", m_SampleType.c_str(), time, lower->first);
                 TraceLoggingWriteStop(local,
                                       "Cache::GetSample",
                                       TLArg(m_SampleType.c_str(), "Type"),
                                       TLArg("Estimated Earlier", "Match"),
-                                      TLArg(lowerIt->first, "Time"));
-                return lowerIt->second;
+                                      TLArg(lower->first, "Time"));
+                Count(Estimated, time - lower->first);
+                return lower->second;
             }
             // cache is empty -> return fallback
             ErrorLog("GetSample(%s) at %u: using fallback!!!", m_SampleType.c_str(), time);
@@ -190,9 +570,47 @@ namespace utility
                                   "Cache::GetSample",
                                   TLArg(m_SampleType.c_str(), "Type"),
                                   TLArg("Fallback", "Match"));
+            Count(Fallback, -1);
             return m_Fallback;
         }
 
+        [[nodiscard]] Statistics GetStatistics() const
+        {
+            Statistics stats;
+            for (size_t i = 0; i < stats.matches.size(); i++)
+            {
+                stats.matches[i] = m_Matches[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < stats.skew.size(); i++)
+            {
+                stats.skew[i] = m_Skew[i].load(std::memory_order_relaxed);
+            }
+            return stats;
+        }
+
+        void LogStatistics() const
+        {
+            const Statistics stats = GetStatistics();
+            std::string histogram;
+            for (size_t i = 0; i < skewLimits.size(); i++)
+            {
+                histogram += fmt::format("<={:.1f}: {}, ", skewLimits[i] / 1000000.0, stats.skew[i]);
+            }
+            histogram += fmt::format(">{:.1f}: {}", skewLimits.back() / 1000000.0, stats.skew.back());
+            openxr_api_layer::log::Log(
+                "%s cache statistics: exact: %llu, interpolated: %llu, extrapolated: %llu, later: %llu, earlier: %llu, "
+                "estimated: %llu, fallback: %llu, time difference (ms): %s",
+                m_SampleType.c_str(),
+                stats.matches[Exact],
+                stats.matches[Interpolated],
+                stats.matches[Extrapolated],
+                stats.matches[Later],
+                stats.matches[Earlier],
+                stats.matches[Estimated],
+                stats.matches[Fallback],
+                histogram.c_str());
+        }
+
         // remove outdated entries
         void CleanUp(const XrTime time)
         {
@@ -200,6 +618,19 @@ namespace utility
             TraceLocalActivity(local);
             TraceLoggingWriteStart(local, "Cache::CleanUp", TLArg(m_SampleType.c_str(), "Type"), TLArg(time, "Time"));
 
+            if constexpr (std::is_trivially_copyable_v<Sample>)
+            {
+                if (m_Ring)
+                {
+                    if (const auto erased = m_Ring->EraseBefore(time - m_Tolerance))
+                    {
+                        TraceLoggingWriteTagged(local, "Cache::CleanUp", TLArg(*erased, "Erased"));
+                    }
+                    TraceLoggingWriteStop(local, "Cache::CleanUp");
+                    return;
+                }
+            }
+
             std::unique_lock lock(m_CacheLock);
 
             auto it = m_Cache.lower_bound(time - m_Tolerance);
@@ -208,7 +639,7 @@ namespace utility
                 --it;
                 if (m_Cache.end() != it && m_Cache.begin() != it)
                 {
-                    TraceLoggingWriteTagged(local, "Cache::CleanUp", TLArg(it->first, "Eraaed"));
+                    TraceLoggingWriteTagged(local, "Cache::CleanUp", TLArg(it->first, "Erased"));
                     m_Cache.erase(m_Cache.begin(), it);
                 }
             }
@@ -217,13 +648,151 @@ namespace utility
         }
 
       private:
+        // without a known frame period the tolerance limits the gap
+        [[nodiscard]] XrTime MaxInterpolationGap() const
+        {
+            const XrTime period = m_FramePeriod.load(std::memory_order_relaxed);
+            return period > 0 ? maxInterpolationFrames * period : m_Tolerance;
+        }
+
+        // negative skew is not added to histogram
+        void Count(const Match match, const XrTime skew) const
+        {
+            m_Matches[match].fetch_add(1, std::memory_order_relaxed);
+            if (0 <= skew)
+            {
+                const auto bucket = std::lower_bound(skewLimits.cbegin(), skewLimits.cend(), skew) - skewLimits.cbegin();
+                m_Skew[bucket].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        // determine last entry before and first entry at or after given time
+        void Bracket(const XrTime time, Neighborhood<Sample>& result) const
+        {
+            // the base entry is only required for extrapolation
+            const size_t baseDistance = m_ExtrapolationLimit > 0 ? extrapolationSamples - 1 : 0;
+            if constexpr (std::is_trivially_copyable_v<Sample>)
+            {
+                if (m_Ring)
+                {
+                    m_Ring->Bracket(time, baseDistance, result);
+                    return;
+                }
+            }
+
+            std::unique_lock lock(m_CacheLock);
+            const auto it = m_Cache.lower_bound(time);
+            if (m_Cache.end() != it)
+            {
+                result.upper = *it;
+            }
+            if (m_Cache.begin() != it)
+            {
+                const auto lowerIt = std::prev(it);
+                result.lower = *lowerIt;
+                auto base = lowerIt;
+                for (size_t i = 0; i < baseDistance && m_Cache.begin() != base; i++)
+                {
+                    --base;
+                }
+                if (base != lowerIt)
+                {
+                    result.lowerBase = *base;
+                }
+            }
+        }
+
         std::map<XrTime, Sample> m_Cache{};
         mutable std::mutex m_CacheLock;
+        // ring buffer sizing: up to two entries per frame (located and submitted time) at 240 Hz
+        static constexpr XrTime minFramePeriod{1000000000 / 240};
+        static constexpr size_t samplesPerFrame{2}, minRingCapacity{16}, maxRingCapacity{4096};
+
+        std::unique_ptr<RingBuffer<Sample>> m_Ring{};
+        bool m_Interpolate{false};
+        static constexpr XrTime maxInterpolationFrames{3};
+        std::atomic<XrTime> m_FramePeriod{0};
+        XrTime m_ExtrapolationLimit{0};
+        // velocity is derived from the two newest entries
+        static constexpr size_t extrapolationSamples{2};
+        mutable std::array<std::atomic<uint64_t>, MatchCount> m_Matches{};
+        mutable std::array<std::atomic<uint64_t>, skewLimits.size() + 1> m_Skew{};
         Sample m_Fallback;
         XrTime m_Tolerance{2000000};
         std::string m_SampleType;
     };
 
+    // accumulates execution time of the per-frame pose pipeline, reported per stage and frame
+    class PipelineTimer
+    {
+      public:
+        enum Stage
+        {
+            TrackerPose = 0,
+            Filter,
+            TrackerModifier,
+            Delta,
+            HmdModifier,
+            ViewPoses,
+            StageCount
+        };
+
+        // measures the lifetime of the scope object, if timing is enabled
+        class Scope
+        {
+          public:
+            explicit Scope(Stage stage);
+            ~Scope();
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+          private:
+            Stage m_Stage;
+            std::chrono::steady_clock::time_point m_Start{};
+        };
+
+        // interval for logging the statistics, 0 = timing is disabled
+        void SetInterval(XrTime interval);
+        [[nodiscard]] bool IsEnabled() const;
+        void Add(Stage stage, int64_t duration);
+        void EndFrame(XrTime time);
+
+      private:
+        void LogStatistics();
+
+        XrTime m_Interval{0};
+        XrTime m_LastLog{0};
+        uint64_t m_Frames{0};
+        std::array<std::atomic<uint64_t>, StageCount> m_Calls{};
+        std::array<std::atomic<uint64_t>, StageCount> m_Total{};
+        std::array<std::atomic<uint64_t>, StageCount> m_Max{};
+        inline static const std::array<const char*, StageCount> m_StageNames{"tracker pose",
+                                                                             "filter",
+                                                                             "tracker modifier",
+                                                                             "delta",
+                                                                             "hmd modifier",
+                                                                             "view poses"};
+    };
+
+    PipelineTimer* GetPipelineTimer();
+
+    // converts xr time into the time base of std::chrono::steady_clock (performance counter), used by the sampler
+    // requires XR_KHR_win32_convert_performance_counter_time to be granted, Init without getInstanceProcAddr otherwise
+    class TimeConverter
+    {
+      public:
+        void Init(XrInstance instance, PFN_xrGetInstanceProcAddr getInstanceProcAddr);
+        [[nodiscard]] bool IsAvailable() const;
+        bool ToSteadyClock(XrTime time, int64_t& steadyTime) const;
+
+      private:
+        XrInstance m_Instance{XR_NULL_HANDLE};
+        PFN_xrConvertTimeToWin32PerformanceCounterKHR m_ConvertTime{nullptr};
+        int64_t m_Frequency{0};
+    };
+
+    TimeConverter* GetTimeConverter();
+
     class DataSource
     {
       public:
@@ -232,6 +801,10 @@ namespace utility
         virtual bool Read(void* buffer, size_t size, int64_t time) = 0;
     };
 
+    // producers may prepend a SequenceHeader to avoid torn reads: the sequence is incremented before and after
+    // writing payload and timestamp, an odd value indicates a write in progress (seqlock)
+    // without matching magic and version the legacy layout (plain payload at offset 0) is read
+    // if the sequence stays odd (producer stuck within a write) the last consistent payload is returned again
     class Mmf : public DataSource
     {
       public:
@@ -242,16 +815,121 @@ namespace utility
         bool Read(void* buffer, size_t size, int64_t time) override;
         void Close();
 
+        struct SequenceHeader
+        {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t payloadOffset;
+            uint64_t sequence;
+            int64_t timestamp; // QueryPerformanceCounter value of the producer
+        };
+        static constexpr uint64_t sequenceMagic{0x514553434d52584f}; // "OXRMCSEQ"
+        static constexpr uint32_t sequenceVersion{1};
+
       private:
+        [[nodiscard]] bool IsSequenced(size_t size) const;
+        bool ReadSequenced(void* buffer, size_t size);
+
+        static constexpr uint32_t maxRetries{1000};
+
         XrTime m_Check{1000000000}; // reopen mmf once a second by default
         XrTime m_LastRefresh{0};
         std::string m_Name;
         HANDLE m_FileHandle{nullptr};
         void* m_View{nullptr};
+        size_t m_ViewSize{0};
         bool m_ConnectionLost{false};
+        bool m_Sequenced{false};
+        uint64_t m_Sequence{0};
+        int64_t m_Frequency{0};
+        uint64_t m_SequencedReads{0};
+        uint64_t m_Retries{0};
+        uint64_t m_StaleReads{0};
+        bool m_TornReadLogged{false};
+        std::vector<char> m_LastPayload{};
         std::mutex m_MmfLock;
     };
 
+    // producer side of Mmf, emulating motion software for tests and tools (on windows and in the portable build)
+    // with a sequence header the payload follows the header and is written using the seqlock protocol read by Mmf
+    class MmfWriter
+    {
+      public:
+        ~MmfWriter();
+        bool Create(const std::string& name, size_t size, bool sequenced);
+        void Write(const void* buffer, size_t size);
+        void Close();
+
+      private:
+        HANDLE m_FileHandle{nullptr};
+        void* m_View{nullptr};
+        size_t m_Offset{0};
+        size_t m_Size{0};
+    };
+
+    // replays the unfiltered values of a recording file (written by output::PoseRecorder) in a loop
+    class Recording : public DataSource
+    {
+      public:
+        void SetFile(const std::filesystem::path& file);
+        bool Open(int64_t time) override;
+        bool Read(void* buffer, size_t size, int64_t time) override;
+
+        // parse unfiltered and filtered dof values of a recording, times are relative to the first sample
+        static bool Parse(const std::filesystem::path& file,
+                          std::vector<int64_t>& times,
+                          std::vector<Dof>& unfiltered,
+                          std::vector<Dof>& filtered);
+
+      private:
+        bool Load();
+
+        std::filesystem::path m_File;
+        std::vector<int64_t> m_Times{};
+        std::vector<Dof> m_Values{};
+        int64_t m_Start{0};
+        std::mutex m_RecordingLock;
+    };
+
+    // generates motion data without a motion platform, for testing sampler and filters over long periods
+    // signals: logarithmic sine sweep (0.1 - 10 Hz), steps, noise only or alternating sweep and steps (mixed)
+    // values are updated at a fixed rate with gaussian noise added and freeze occasionally (dropouts)
+    class Synthetic : public DataSource
+    {
+      public:
+        void Configure(const std::string& signal, float rate, float noise, float dropouts);
+        bool Open(int64_t time) override;
+        bool Read(void* buffer, size_t size, int64_t time) override;
+
+      private:
+        enum Signal
+        {
+            Sweep = 0,
+            Step,
+            Noise,
+            Mixed
+        };
+
+        [[nodiscard]] float Generate(size_t index, double elapsed) const;
+
+        static constexpr double sweepDuration{60.0}, stepDuration{20.0};
+        static constexpr double minFrequency{0.1}, maxFrequency{10.0};
+        static constexpr int64_t dropoutDuration{250000000};
+        // amplitudes in mm and degrees, in dof order
+        static constexpr std::array<float, 6> amplitude{50.f, 50.f, 50.f, 30.f, 10.f, 10.f};
+
+        Signal m_Signal{Mixed};
+        int64_t m_UpdateInterval{4000000};
+        float m_Noise{0.01f};
+        double m_DropoutProbability{0.0};
+        std::mt19937 m_Generator{std::random_device{}()};
+        int64_t m_Start{0};
+        int64_t m_LastUpdate{0};
+        int64_t m_DropoutEnd{0};
+        Dof m_Current{};
+        std::mutex m_SyntheticLock;
+    };
+
     static inline bool endsWith(const std::string& str, const std::string& substr)
     {
         const auto pos = str.find(substr);
@@ -0,0 +1,221 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// scalar stand-in for the subset of DirectXMath used by the platform independent modules (portable build only)
+// semantics follow DirectXMath, e.g. XMQuaternionMultiply(q1, q2) yields the rotation q1 followed by q2
+
+#include <algorithm>
+#include <cmath>
+
+#define XM_CALLCONV
+
+namespace DirectX
+{
+    struct XMVECTOR
+    {
+        float v[4];
+    };
+    typedef const XMVECTOR FXMVECTOR;
+    typedef const XMVECTOR GXMVECTOR;
+    typedef const XMVECTOR HXMVECTOR;
+    typedef const XMVECTOR& CXMVECTOR;
+
+    struct XMVECTORF32
+    {
+        union
+        {
+            float f[4];
+            XMVECTOR v;
+        };
+        operator XMVECTOR() const
+        {
+            return v;
+        }
+    };
+
+    inline const XMVECTORF32 g_XMOne{{{1.f, 1.f, 1.f, 1.f}}};
+    inline const XMVECTORF32 g_XMZero{{{0.f, 0.f, 0.f, 0.f}}};
+    inline const XMVECTORF32 g_XMIdentityR3{{{0.f, 0.f, 0.f, 1.f}}};
+
+    inline XMVECTOR XM_CALLCONV XMVectorSet(const float x, const float y, const float z, const float w)
+    {
+        return {{x, y, z, w}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorReplicate(const float value)
+    {
+        return {{value, value, value, value}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorZero()
+    {
+        return {{0.f, 0.f, 0.f, 0.f}};
+    }
+
+    inline float XM_CALLCONV XMVectorGetX(FXMVECTOR v)
+    {
+        return v.v[0];
+    }
+
+    inline float XM_CALLCONV XMVectorGetW(FXMVECTOR v)
+    {
+        return v.v[3];
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorAdd(FXMVECTOR a, FXMVECTOR b)
+    {
+        return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorSubtract(FXMVECTOR a, FXMVECTOR b)
+    {
+        return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorMultiply(FXMVECTOR a, FXMVECTOR b)
+    {
+        return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorMultiplyAdd(FXMVECTOR a, FXMVECTOR b, FXMVECTOR c)
+    {
+        return {{a.v[0] * b.v[0] + c.v[0], a.v[1] * b.v[1] + c.v[1], a.v[2] * b.v[2] + c.v[2], a.v[3] * b.v[3] + c.v[3]}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorScale(FXMVECTOR v, const float scale)
+    {
+        return {{v.v[0] * scale, v.v[1] * scale, v.v[2] * scale, v.v[3] * scale}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorNegate(FXMVECTOR v)
+    {
+        return {{-v.v[0], -v.v[1], -v.v[2], -v.v[3]}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVectorLerp(FXMVECTOR a, FXMVECTOR b, const float t)
+    {
+        return XMVectorAdd(a, XMVectorScale(XMVectorSubtract(b, a), t));
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVector3Dot(FXMVECTOR a, FXMVECTOR b)
+    {
+        return XMVectorReplicate(a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2]);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVector4Dot(FXMVECTOR a, FXMVECTOR b)
+    {
+        return XMVectorReplicate(a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2] + a.v[3] * b.v[3]);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVector3Length(FXMVECTOR v)
+    {
+        return XMVectorReplicate(std::sqrt(XMVectorGetX(XMVector3Dot(v, v))));
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVector3Normalize(FXMVECTOR v)
+    {
+        const float length = XMVectorGetX(XMVector3Length(v));
+        return length > 0.f ? XMVectorScale(v, 1.f / length) : XMVectorZero();
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVector3Cross(FXMVECTOR a, FXMVECTOR b)
+    {
+        return {{a.v[1] * b.v[2] - a.v[2] * b.v[1], a.v[2] * b.v[0] - a.v[0] * b.v[2], a.v[0] * b.v[1] - a.v[1] * b.v[0], 0.f}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMQuaternionIdentity()
+    {
+        return g_XMIdentityR3;
+    }
+
+    inline XMVECTOR XM_CALLCONV XMQuaternionDot(FXMVECTOR a, FXMVECTOR b)
+    {
+        return XMVector4Dot(a, b);
+    }
+
+    inline XMVECTOR XM_CALLCONV XMQuaternionNormalize(FXMVECTOR q)
+    {
+        const float length = std::sqrt(XMVectorGetX(XMVector4Dot(q, q)));
+        return length > 0.f ? XMVectorScale(q, 1.f / length) : XMVectorZero();
+    }
+
+    inline XMVECTOR XM_CALLCONV XMQuaternionConjugate(FXMVECTOR q)
+    {
+        return {{-q.v[0], -q.v[1], -q.v[2], q.v[3]}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMQuaternionInverse(FXMVECTOR q)
+    {
+        const float lengthSq = XMVectorGetX(XMVector4Dot(q, q));
+        return lengthSq > 0.f ? XMVectorScale(XMQuaternionConjugate(q), 1.f / lengthSq) : XMVectorZero();
+    }
+
+    // returns q2 * q1 (hamilton product), i.e. rotation q1 followed by q2
+    inline XMVECTOR XM_CALLCONV XMQuaternionMultiply(FXMVECTOR q1, FXMVECTOR q2)
+    {
+        const float* a = q2.v;
+        const float* b = q1.v;
+        return {{a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1],
+                 a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0],
+                 a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3],
+                 a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2]}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMQuaternionSlerp(FXMVECTOR q0, FXMVECTOR q1, const float t)
+    {
+        constexpr float oneMinusEpsilon{1.0f - 0.00001f};
+        float cosOmega = XMVectorGetX(XMVector4Dot(q0, q1));
+        const float sign = cosOmega < 0.f ? -1.f : 1.f;
+        cosOmega *= sign;
+        float scale0, scale1;
+        if (cosOmega < oneMinusEpsilon)
+        {
+            const float sinOmega = std::sqrt(1.f - cosOmega * cosOmega);
+            const float omega = std::atan2(sinOmega, cosOmega);
+            scale0 = std::sin((1.f - t) * omega) / sinOmega;
+            scale1 = std::sin(t * omega) / sinOmega;
+        }
+        else
+        {
+            scale0 = 1.f - t;
+            scale1 = t;
+        }
+        return XMVectorAdd(XMVectorScale(q0, scale0), XMVectorScale(q1, sign * scale1));
+    }
+
+    inline XMVECTOR XM_CALLCONV XMQuaternionRotationNormal(FXMVECTOR normalAxis, const float angle)
+    {
+        const float sinHalf = std::sin(0.5f * angle);
+        return {{normalAxis.v[0] * sinHalf, normalAxis.v[1] * sinHalf, normalAxis.v[2] * sinHalf, std::cos(0.5f * angle)}};
+    }
+
+    inline XMVECTOR XM_CALLCONV XMQuaternionRotationAxis(FXMVECTOR axis, const float angle)
+    {
+        return XMQuaternionRotationNormal(XMVector3Normalize(axis), angle);
+    }
+
+    // rotation about z (roll), followed by x (pitch) and y (yaw)
+    inline XMVECTOR XM_CALLCONV XMQuaternionRotationRollPitchYaw(const float pitch, const float yaw, const float roll)
+    {
+        const float sp = std::sin(0.5f * pitch), cp = std::cos(0.5f * pitch);
+        const float sy = std::sin(0.5f * yaw), cy = std::cos(0.5f * yaw);
+        const float sr = std::sin(0.5f * roll), cr = std::cos(0.5f * roll);
+        return {{cr * sp * cy + sr * cp * sy,
+                 cr * cp * sy - sr * sp * cy,
+                 sr * cp * cy - cr * sp * sy,
+                 cr * cp * cy + sr * sp * sy}};
+    }
+
+    inline void XM_CALLCONV XMQuaternionToAxisAngle(XMVECTOR* axis, float* angle, FXMVECTOR q)
+    {
+        *axis = q;
+        *angle = 2.f * std::acos(std::clamp(XMVectorGetW(q), -1.f, 1.f));
+    }
+
+    inline XMVECTOR XM_CALLCONV XMVector3Rotate(FXMVECTOR v, FXMVECTOR q)
+    {
+        const XMVECTOR a{{v.v[0], v.v[1], v.v[2], 0.f}};
+        return XMQuaternionMultiply(XMQuaternionMultiply(XMQuaternionConjugate(q), a), q);
+    }
+} // namespace DirectX
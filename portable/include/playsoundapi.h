@@ -0,0 +1,13 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// stand-in for the Windows audio playback api, sounds are discarded (portable build only)
+
+#include <portable.h>
+
+#define SND_ASYNC 0x0001
+#define SND_RESOURCE 0x00040004L
+#define MAKEINTRESOURCE(id) (reinterpret_cast<LPCSTR>(static_cast<uintptr_t>(id)))
+
+BOOL PlaySound(LPCSTR sound, HMODULE module, DWORD flags);
@@ -0,0 +1,460 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+// stand-ins for the Windows, OpenXR and TraceLogging declarations used by the platform independent modules
+// (config, filter, modifier, output, utility) so they can be built and tested without the Windows SDK
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <DirectXMath.h>
+
+// Windows
+typedef int BOOL;
+typedef unsigned long DWORD;
+typedef void* HANDLE;
+typedef void* HMODULE;
+typedef void* LPVOID;
+typedef const void* LPCVOID;
+typedef char* LPSTR;
+typedef char* LPTSTR;
+typedef const char* LPCSTR;
+typedef const wchar_t* LPCWSTR;
+typedef size_t SIZE_T;
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+#define INFINITE 0xFFFFFFFF
+#define WAIT_OBJECT_0 0
+#define WAIT_FAILED 0xFFFFFFFF
+#define _TRUNCATE (static_cast<size_t>(-1))
+
+union LARGE_INTEGER
+{
+    int64_t QuadPart;
+};
+
+struct FILETIME
+{
+    DWORD dwLowDateTime;
+    DWORD dwHighDateTime;
+};
+
+struct SYSTEMTIME
+{
+    uint16_t wYear;
+    uint16_t wMonth;
+    uint16_t wDayOfWeek;
+    uint16_t wDay;
+    uint16_t wHour;
+    uint16_t wMinute;
+    uint16_t wSecond;
+    uint16_t wMilliseconds;
+};
+
+struct MEMORY_BASIC_INFORMATION
+{
+    LPVOID BaseAddress;
+    SIZE_T RegionSize;
+};
+
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#define TIMER_MODIFY_STATE 0x0002
+#define SYNCHRONIZE 0x00100000L
+#define FILE_MAP_WRITE 0x0002
+#define FILE_MAP_READ 0x0004
+#define FILE_MAP_ALL_ACCESS 0x000F001F
+#define PAGE_READWRITE 0x04
+#define INVALID_HANDLE_VALUE (reinterpret_cast<HANDLE>(-1))
+#define FORMAT_MESSAGE_ALLOCATE_BUFFER 0x00000100
+#define FORMAT_MESSAGE_IGNORE_INSERTS 0x00000200
+#define FORMAT_MESSAGE_FROM_SYSTEM 0x00001000
+#define LANG_NEUTRAL 0x00
+#define SUBLANG_DEFAULT 0x01
+#define MAKELANGID(p, s) ((static_cast<DWORD>(s) << 10) | static_cast<DWORD>(p))
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* counter);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency);
+void GetLocalTime(SYSTEMTIME* time);
+HANDLE GetCurrentThread();
+BOOL GetThreadTimes(HANDLE thread, FILETIME* creation, FILETIME* exit, FILETIME* kernel, FILETIME* user);
+HANDLE CreateWaitableTimerExW(LPVOID attributes, LPCWSTR name, DWORD flags, DWORD access);
+BOOL SetWaitableTimer(HANDLE timer,
+                      const LARGE_INTEGER* dueTime,
+                      long period,
+                      LPVOID completion,
+                      LPVOID argument,
+                      BOOL resume);
+DWORD WaitForSingleObject(HANDLE handle, DWORD milliseconds);
+BOOL CloseHandle(HANDLE handle);
+HANDLE CreateFileMapping(HANDLE file,
+                         LPVOID attributes,
+                         DWORD protection,
+                         DWORD maximumSizeHigh,
+                         DWORD maximumSizeLow,
+                         LPCSTR name);
+HANDLE OpenFileMapping(DWORD access, BOOL inherit, LPCSTR name);
+LPVOID MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh, DWORD offsetLow, SIZE_T size);
+BOOL UnmapViewOfFile(LPCVOID view);
+SIZE_T VirtualQuery(LPCVOID address, MEMORY_BASIC_INFORMATION* info, SIZE_T length);
+DWORD GetLastError();
+DWORD FormatMessage(DWORD flags, LPCVOID source, DWORD id, DWORD language, LPTSTR buffer, DWORD size, va_list* args);
+LPVOID LocalFree(LPVOID memory);
+DWORD GetPrivateProfileString(LPCSTR section, LPCSTR key, LPCSTR fallback, LPSTR buffer, DWORD size, LPCSTR file);
+BOOL WritePrivateProfileString(LPCSTR section, LPCSTR key, LPCSTR value, LPCSTR file);
+int _access(const char* path, int mode);
+int vsnprintf_s(char* buffer, size_t size, size_t count, const char* format, va_list args);
+
+inline void YieldProcessor()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// virtual key codes
+#define VK_BACK 0x08
+#define VK_TAB 0x09
+#define VK_CLEAR 0x0C
+#define VK_RETURN 0x0D
+#define VK_SHIFT 0x10
+#define VK_CONTROL 0x11
+#define VK_MENU 0x12
+#define VK_PAUSE 0x13
+#define VK_CAPITAL 0x14
+#define VK_ESCAPE 0x1B
+#define VK_SPACE 0x20
+#define VK_PRIOR 0x21
+#define VK_NEXT 0x22
+#define VK_END 0x23
+#define VK_HOME 0x24
+#define VK_LEFT 0x25
+#define VK_UP 0x26
+#define VK_RIGHT 0x27
+#define VK_DOWN 0x28
+#define VK_SELECT 0x29
+#define VK_PRINT 0x2A
+#define VK_EXECUTE 0x2B
+#define VK_SNAPSHOT 0x2C
+#define VK_INSERT 0x2D
+#define VK_DELETE 0x2E
+#define VK_HELP 0x2F
+#define VK_NUMPAD0 0x60
+#define VK_NUMPAD1 0x61
+#define VK_NUMPAD2 0x62
+#define VK_NUMPAD3 0x63
+#define VK_NUMPAD4 0x64
+#define VK_NUMPAD5 0x65
+#define VK_NUMPAD6 0x66
+#define VK_NUMPAD7 0x67
+#define VK_NUMPAD8 0x68
+#define VK_NUMPAD9 0x69
+#define VK_MULTIPLY 0x6A
+#define VK_ADD 0x6B
+#define VK_SEPARATOR 0x6C
+#define VK_SUBTRACT 0x6D
+#define VK_DECIMAL 0x6E
+#define VK_DIVIDE 0x6F
+#define VK_F1 0x70
+#define VK_F2 0x71
+#define VK_F3 0x72
+#define VK_F4 0x73
+#define VK_F5 0x74
+#define VK_F6 0x75
+#define VK_F7 0x76
+#define VK_F8 0x77
+#define VK_F9 0x78
+#define VK_F10 0x79
+#define VK_F11 0x7A
+#define VK_F12 0x7B
+#define VK_NUMLOCK 0x90
+#define VK_SCROLL 0x91
+#define VK_LSHIFT 0xA0
+#define VK_RSHIFT 0xA1
+#define VK_LCONTROL 0xA2
+#define VK_RCONTROL 0xA3
+#define VK_LMENU 0xA4
+#define VK_RMENU 0xA5
+#define VK_OEM_1 0xBA
+#define VK_OEM_PLUS 0xBB
+#define VK_OEM_COMMA 0xBC
+#define VK_OEM_MINUS 0xBD
+#define VK_OEM_PERIOD 0xBE
+#define VK_OEM_2 0xBF
+#define VK_OEM_3 0xC0
+#define VK_GAMEPAD_A 0xC3
+#define VK_GAMEPAD_B 0xC4
+#define VK_GAMEPAD_X 0xC5
+#define VK_GAMEPAD_Y 0xC6
+#define VK_GAMEPAD_RIGHT_SHOULDER 0xC7
+#define VK_GAMEPAD_LEFT_SHOULDER 0xC8
+#define VK_GAMEPAD_LEFT_TRIGGER 0xC9
+#define VK_GAMEPAD_RIGHT_TRIGGER 0xCA
+#define VK_GAMEPAD_DPAD_UP 0xCB
+#define VK_GAMEPAD_DPAD_DOWN 0xCC
+#define VK_GAMEPAD_DPAD_LEFT 0xCD
+#define VK_GAMEPAD_DPAD_RIGHT 0xCE
+#define VK_GAMEPAD_MENU 0xCF
+#define VK_GAMEPAD_VIEW 0xD0
+#define VK_GAMEPAD_LEFT_THUMBSTICK_BUTTON 0xD1
+#define VK_GAMEPAD_RIGHT_THUMBSTICK_BUTTON 0xD2
+#define VK_GAMEPAD_LEFT_THUMBSTICK_UP 0xD3
+#define VK_GAMEPAD_LEFT_THUMBSTICK_DOWN 0xD4
+#define VK_GAMEPAD_LEFT_THUMBSTICK_RIGHT 0xD5
+#define VK_GAMEPAD_LEFT_THUMBSTICK_LEFT 0xD6
+#define VK_GAMEPAD_RIGHT_THUMBSTICK_UP 0xD7
+#define VK_GAMEPAD_RIGHT_THUMBSTICK_DOWN 0xD8
+#define VK_GAMEPAD_RIGHT_THUMBSTICK_RIGHT 0xD9
+#define VK_GAMEPAD_RIGHT_THUMBSTICK_LEFT 0xDA
+#define VK_OEM_4 0xDB
+#define VK_OEM_5 0xDC
+#define VK_OEM_6 0xDD
+#define VK_OEM_7 0xDE
+
+// TraceLogging: events are discarded, arguments are type checked but never evaluated
+typedef const struct TraceLoggingProvider* TraceLoggingHProvider;
+
+#define TRACELOGGING_DECLARE_PROVIDER(handle) extern const TraceLoggingHProvider handle
+#define TRACELOGGING_DEFINE_PROVIDER(handle, name, id) const TraceLoggingHProvider handle{nullptr}
+#define TraceLoggingProviderEnabled(provider, level, keyword) false
+
+template <const TraceLoggingHProvider& Provider>
+class TraceLoggingActivity
+{
+  public:
+    TraceLoggingActivity()
+    {}
+};
+
+template <typename... Args>
+inline void TraceLoggingDiscard(const Args&...)
+{}
+
+#define TraceLoggingValue(value, ...) (value)
+#define TraceLoggingPointer(value, ...) (value)
+#define TraceLoggingWrite(provider, ...) \
+    do \
+    { \
+        if (false) \
+            TraceLoggingDiscard(__VA_ARGS__); \
+    } while (false)
+#define TraceLoggingWriteStart(activity, ...) TraceLoggingWrite(nullptr, activity, __VA_ARGS__)
+#define TraceLoggingWriteTagged(activity, ...) TraceLoggingWrite(nullptr, activity, __VA_ARGS__)
+#define TraceLoggingWriteStop(activity, ...) TraceLoggingWrite(nullptr, activity, __VA_ARGS__)
+
+// OpenXR
+typedef int64_t XrTime;
+typedef int64_t XrDuration;
+typedef uint64_t XrVersion;
+typedef struct XrInstance_T* XrInstance;
+typedef struct XrSession_T* XrSession;
+typedef struct XrSpace_T* XrSpace;
+
+#define XR_NULL_HANDLE nullptr
+#define XR_VERSION_MAJOR(version) (uint16_t)(((uint64_t)(version) >> 48) & 0xffffULL)
+#define XR_VERSION_MINOR(version) (uint16_t)(((uint64_t)(version) >> 32) & 0xffffULL)
+#define XR_VERSION_PATCH(version) (uint32_t)((uint64_t)(version)&0xffffffffULL)
+
+enum XrResult
+{
+    XR_SUCCESS = 0,
+    XR_ERROR_RUNTIME_FAILURE = -2,
+    XR_ERROR_FUNCTION_UNSUPPORTED = -7
+};
+#define XR_SUCCEEDED(result) ((result) >= 0)
+#define XR_FAILED(result) ((result) < 0)
+
+struct XrVector3f
+{
+    float x;
+    float y;
+    float z;
+};
+
+struct XrQuaternionf
+{
+    float x;
+    float y;
+    float z;
+    float w;
+};
+
+struct XrPosef
+{
+    XrQuaternionf orientation;
+    XrVector3f position;
+};
+
+struct XrFovf
+{
+    float angleLeft;
+    float angleRight;
+    float angleUp;
+    float angleDown;
+};
+
+struct XrOffset2Di
+{
+    int32_t x;
+    int32_t y;
+};
+
+struct XrExtent2Di
+{
+    int32_t width;
+    int32_t height;
+};
+
+struct XrRect2Di
+{
+    XrOffset2Di offset;
+    XrExtent2Di extent;
+};
+
+struct XrOffset2Df
+{
+    float x;
+    float y;
+};
+
+struct XrExtent2Df
+{
+    float width;
+    float height;
+};
+
+struct XrRect2Df
+{
+    XrOffset2Df offset;
+    XrExtent2Df extent;
+};
+
+typedef void (*PFN_xrVoidFunction)();
+typedef XrResult (*PFN_xrGetInstanceProcAddr)(XrInstance instance, const char* name, PFN_xrVoidFunction* function);
+typedef XrResult (*PFN_xrConvertTimeToWin32PerformanceCounterKHR)(XrInstance instance,
+                                                                   XrTime time,
+                                                                   LARGE_INTEGER* performanceCounter);
+
+// subset of XrMath.h
+inline XrVector3f operator+(const XrVector3f& a, const XrVector3f& b)
+{
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+inline XrVector3f operator-(const XrVector3f& a, const XrVector3f& b)
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+inline XrVector3f operator-(const XrVector3f& a)
+{
+    return {-a.x, -a.y, -a.z};
+}
+
+inline XrVector3f operator*(const XrVector3f& a, const XrVector3f& b)
+{
+    return {a.x * b.x, a.y * b.y, a.z * b.z};
+}
+
+inline XrVector3f operator*(const XrVector3f& a, const float s)
+{
+    return {a.x * s, a.y * s, a.z * s};
+}
+
+inline XrVector3f operator*(const float s, const XrVector3f& a)
+{
+    return a * s;
+}
+
+inline XrVector3f operator/(const XrVector3f& a, const float s)
+{
+    return {a.x / s, a.y / s, a.z / s};
+}
+
+namespace xr::math
+{
+    struct NearFar
+    {
+        float Near;
+        float Far;
+    };
+
+    inline DirectX::XMVECTOR XM_CALLCONV LoadXrVector3(const XrVector3f& vector)
+    {
+        return DirectX::XMVectorSet(vector.x, vector.y, vector.z, 0.f);
+    }
+
+    inline void XM_CALLCONV StoreXrVector3(XrVector3f* out, DirectX::FXMVECTOR vector)
+    {
+        *out = {vector.v[0], vector.v[1], vector.v[2]};
+    }
+
+    inline DirectX::XMVECTOR XM_CALLCONV LoadXrQuaternion(const XrQuaternionf& quaternion)
+    {
+        return DirectX::XMVectorSet(quaternion.x, quaternion.y, quaternion.z, quaternion.w);
+    }
+
+    inline void XM_CALLCONV StoreXrQuaternion(XrQuaternionf* out, DirectX::FXMVECTOR quaternion)
+    {
+        *out = {quaternion.v[0], quaternion.v[1], quaternion.v[2], quaternion.v[3]};
+    }
+
+    namespace Quaternion
+    {
+        inline XrQuaternionf Identity()
+        {
+            return {0.f, 0.f, 0.f, 1.f};
+        }
+
+        inline XrQuaternionf Slerp(const XrQuaternionf& a, const XrQuaternionf& b, const float alpha)
+        {
+            XrQuaternionf result;
+            StoreXrQuaternion(&result, DirectX::XMQuaternionSlerp(LoadXrQuaternion(a), LoadXrQuaternion(b), alpha));
+            return result;
+        }
+    } // namespace Quaternion
+
+    namespace Pose
+    {
+        inline XrPosef Identity()
+        {
+            return {Quaternion::Identity(), {0.f, 0.f, 0.f}};
+        }
+
+        inline XrPosef Translation(const XrVector3f& translation)
+        {
+            return {Quaternion::Identity(), translation};
+        }
+
+        // transforms a into the space of b
+        inline XrPosef Multiply(const XrPosef& a, const XrPosef& b)
+        {
+            using namespace DirectX;
+            const XMVECTOR orientationB = LoadXrQuaternion(b.orientation);
+            XrPosef result;
+            StoreXrQuaternion(&result.orientation,
+                              XMQuaternionMultiply(LoadXrQuaternion(a.orientation), orientationB));
+            StoreXrVector3(&result.position,
+                           XMVectorAdd(XMVector3Rotate(LoadXrVector3(a.position), orientationB),
+                                       LoadXrVector3(b.position)));
+            return result;
+        }
+
+        inline XrPosef Invert(const XrPosef& pose)
+        {
+            using namespace DirectX;
+            const XMVECTOR orientation = XMQuaternionInverse(LoadXrQuaternion(pose.orientation));
+            XrPosef result;
+            StoreXrQuaternion(&result.orientation, orientation);
+            StoreXrVector3(&result.position,
+                           XMVector3Rotate(XMVectorNegate(LoadXrVector3(pose.position)), orientation));
+            return result;
+        }
+    } // namespace Pose
+} // namespace xr::math
@@ -0,0 +1,415 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+#include "globals.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// globals otherwise defined by the layer entry point (framework/entry.cpp), see globals.h
+namespace openxr_api_layer
+{
+    // The handle of the dll
+    HMODULE dllModule{nullptr};
+
+    // The path that is writable (eg: to store logs).
+    std::filesystem::path localAppData;
+
+    namespace log
+    {
+        // The file logger.
+        std::ofstream logStream;
+    } // namespace log
+} // namespace openxr_api_layer
+
+namespace
+{
+    constexpr int64_t nanosecondsPerSecond{1000000000};
+
+    struct Handle
+    {
+        explicit Handle(const int fd, std::string created = {}) : fd(fd), created(std::move(created))
+        {}
+        ~Handle()
+        {
+            close(fd);
+            if (!created.empty())
+            {
+                shm_unlink(created.c_str());
+            }
+        }
+        int fd;
+        // shared memory object created with this handle, removed on close like a windows file mapping
+        std::string created;
+    };
+
+    // mapped views and their size, required for unmapping and VirtualQuery
+    std::mutex g_ViewLock;
+    std::map<const void*, size_t> g_Views;
+
+    // named file mappings correspond to posix shared memory objects
+    std::string SharedMemoryName(const char* name)
+    {
+        std::string object = std::string("/") + name;
+        std::replace(object.begin() + 1, object.end(), '\\', '_');
+        std::replace(object.begin() + 1, object.end(), '/', '_');
+        return object;
+    }
+
+    int64_t ToNanoseconds(const timeval& time)
+    {
+        return static_cast<int64_t>(time.tv_sec) * nanosecondsPerSecond + static_cast<int64_t>(time.tv_usec) * 1000;
+    }
+
+    FILETIME ToFileTime(const int64_t nanoseconds)
+    {
+        const uint64_t ticks = static_cast<uint64_t>(nanoseconds / 100);
+        return {static_cast<DWORD>(ticks & 0xffffffff), static_cast<DWORD>(ticks >> 32)};
+    }
+
+    std::string Trim(const std::string& text)
+    {
+        const size_t first = text.find_first_not_of(" \t\r\n");
+        if (std::string::npos == first)
+        {
+            return {};
+        }
+        return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+    }
+
+    bool EqualsIgnoreCase(const std::string& a, const std::string& b)
+    {
+        return a.size() == b.size() && std::equal(a.cbegin(), a.cend(), b.cbegin(), [](const char x, const char y) {
+                   return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+               });
+    }
+
+    // returns the section name of a line or an empty string if the line is not a section header
+    std::string SectionOf(const std::string& line)
+    {
+        const std::string trimmed = Trim(line);
+        return trimmed.size() > 2 && '[' == trimmed.front() && ']' == trimmed.back()
+                   ? Trim(trimmed.substr(1, trimmed.size() - 2))
+                   : std::string{};
+    }
+
+    // splits a key=value line, returns false for comments and lines without assignment
+    bool SplitEntry(const std::string& line, std::string& key, std::string& value)
+    {
+        const std::string trimmed = Trim(line);
+        const size_t separator = trimmed.find('=');
+        if (trimmed.empty() || ';' == trimmed.front() || std::string::npos == separator)
+        {
+            return false;
+        }
+        key = Trim(trimmed.substr(0, separator));
+        value = Trim(trimmed.substr(separator + 1));
+        if (value.size() > 1 && ('"' == value.front() || '\'' == value.front()) && value.front() == value.back())
+        {
+            value = value.substr(1, value.size() - 2);
+        }
+        return true;
+    }
+
+    bool ReadLines(const char* file, std::vector<std::string>& lines)
+    {
+        std::ifstream stream(file);
+        if (!stream.is_open())
+        {
+            errno = ENOENT;
+            return false;
+        }
+        for (std::string line; std::getline(stream, line);)
+        {
+            lines.push_back(line);
+        }
+        return true;
+    }
+} // namespace
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* counter)
+{
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    counter->QuadPart = static_cast<int64_t>(now.tv_sec) * nanosecondsPerSecond + now.tv_nsec;
+    return TRUE;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency)
+{
+    frequency->QuadPart = nanosecondsPerSecond;
+    return TRUE;
+}
+
+void GetLocalTime(SYSTEMTIME* time)
+{
+    timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    tm local{};
+    localtime_r(&now.tv_sec, &local);
+    *time = {static_cast<uint16_t>(local.tm_year + 1900),
+             static_cast<uint16_t>(local.tm_mon + 1),
+             static_cast<uint16_t>(local.tm_wday),
+             static_cast<uint16_t>(local.tm_mday),
+             static_cast<uint16_t>(local.tm_hour),
+             static_cast<uint16_t>(local.tm_min),
+             static_cast<uint16_t>(local.tm_sec),
+             static_cast<uint16_t>(now.tv_nsec / 1000000)};
+}
+
+HANDLE GetCurrentThread()
+{
+    // pseudo handle, only used to refer to the calling thread
+    return reinterpret_cast<HANDLE>(-2);
+}
+
+BOOL GetThreadTimes(HANDLE, FILETIME* creation, FILETIME* exit, FILETIME* kernel, FILETIME* user)
+{
+    rusage usage{};
+    if (0 != getrusage(RUSAGE_THREAD, &usage))
+    {
+        return FALSE;
+    }
+    *creation = *exit = {};
+    *kernel = ToFileTime(ToNanoseconds(usage.ru_stime));
+    *user = ToFileTime(ToNanoseconds(usage.ru_utime));
+    return TRUE;
+}
+
+HANDLE CreateWaitableTimerExW(LPVOID, LPCWSTR, DWORD, DWORD)
+{
+    const int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    return fd >= 0 ? new Handle(fd) : nullptr;
+}
+
+BOOL SetWaitableTimer(HANDLE timer, const LARGE_INTEGER* dueTime, long, LPVOID, LPVOID, BOOL)
+{
+    // only relative due times (negative, in 100 ns units) are supported
+    const int64_t nanoseconds = std::max(-dueTime->QuadPart, int64_t{1}) * 100;
+    itimerspec spec{};
+    spec.it_value.tv_sec = nanoseconds / nanosecondsPerSecond;
+    spec.it_value.tv_nsec = nanoseconds % nanosecondsPerSecond;
+    return 0 == timerfd_settime(static_cast<Handle*>(timer)->fd, 0, &spec, nullptr);
+}
+
+DWORD WaitForSingleObject(HANDLE handle, DWORD)
+{
+    uint64_t expirations;
+    return sizeof(expirations) == read(static_cast<Handle*>(handle)->fd, &expirations, sizeof(expirations))
+               ? WAIT_OBJECT_0
+               : WAIT_FAILED;
+}
+
+BOOL CloseHandle(HANDLE handle)
+{
+    delete static_cast<Handle*>(handle);
+    return TRUE;
+}
+
+HANDLE CreateFileMapping(HANDLE, LPVOID, DWORD, const DWORD maximumSizeHigh, const DWORD maximumSizeLow, LPCSTR name)
+{
+    // only named mappings backed by the paging file (INVALID_HANDLE_VALUE) are supported
+    // an existing object is opened and enlarged if required, but only removed on close by its creator
+    const std::string object = SharedMemoryName(name);
+    std::string created = object;
+    int fd = shm_open(object.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && EEXIST == errno)
+    {
+        created.clear();
+        fd = shm_open(object.c_str(), O_RDWR, 0);
+    }
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    auto handle = std::make_unique<Handle>(fd, std::move(created));
+    const auto size = static_cast<off_t>((static_cast<uint64_t>(maximumSizeHigh) << 32) | maximumSizeLow);
+    struct stat info{};
+    if (0 != fstat(fd, &info) || (info.st_size < size && 0 != ftruncate(fd, size)))
+    {
+        const int error = errno;
+        handle.reset();
+        errno = error;
+        return nullptr;
+    }
+    return handle.release();
+}
+
+HANDLE OpenFileMapping(DWORD, BOOL, LPCSTR name)
+{
+    const int fd = shm_open(SharedMemoryName(name).c_str(), O_RDONLY, 0);
+    return fd >= 0 ? new Handle(fd) : nullptr;
+}
+
+LPVOID MapViewOfFile(HANDLE mapping, const DWORD access, DWORD, DWORD, SIZE_T size)
+{
+    const int fd = static_cast<Handle*>(mapping)->fd;
+    struct stat info{};
+    if (0 == size && 0 == fstat(fd, &info))
+    {
+        size = static_cast<size_t>(info.st_size);
+    }
+    if (0 == size)
+    {
+        errno = EINVAL;
+        return nullptr;
+    }
+    const int protection = access & FILE_MAP_WRITE ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* view = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == view)
+    {
+        return nullptr;
+    }
+    std::unique_lock lock(g_ViewLock);
+    g_Views[view] = size;
+    return view;
+}
+
+BOOL UnmapViewOfFile(LPCVOID view)
+{
+    std::unique_lock lock(g_ViewLock);
+    const auto it = g_Views.find(view);
+    if (it == g_Views.end())
+    {
+        errno = EINVAL;
+        return FALSE;
+    }
+    munmap(const_cast<void*>(view), it->second);
+    g_Views.erase(it);
+    return TRUE;
+}
+
+SIZE_T VirtualQuery(LPCVOID address, MEMORY_BASIC_INFORMATION* info, SIZE_T length)
+{
+    std::unique_lock lock(g_ViewLock);
+    const auto it = g_Views.find(address);
+    if (it == g_Views.end() || length < sizeof(MEMORY_BASIC_INFORMATION))
+    {
+        return 0;
+    }
+    *info = {const_cast<void*>(address), it->second};
+    return sizeof(MEMORY_BASIC_INFORMATION);
+}
+
+DWORD GetLastError()
+{
+    return static_cast<DWORD>(errno);
+}
+
+DWORD FormatMessage(DWORD, LPCVOID, DWORD id, DWORD, LPTSTR buffer, DWORD, va_list*)
+{
+    // only FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM is supported
+    char* message = strdup(strerror(static_cast<int>(id)));
+    *reinterpret_cast<char**>(buffer) = message;
+    return message ? static_cast<DWORD>(strlen(message)) : 0;
+}
+
+LPVOID LocalFree(LPVOID memory)
+{
+    free(memory);
+    return nullptr;
+}
+
+DWORD GetPrivateProfileString(LPCSTR section, LPCSTR key, LPCSTR fallback, LPSTR buffer, DWORD size, LPCSTR file)
+{
+    std::string result = fallback ? fallback : "";
+    std::vector<std::string> lines;
+    if (ReadLines(file, lines))
+    {
+        bool inSection{false};
+        for (const std::string& line : lines)
+        {
+            if (const std::string current = SectionOf(line); !current.empty())
+            {
+                inSection = EqualsIgnoreCase(current, section);
+                continue;
+            }
+            if (std::string entryKey, entryValue;
+                inSection && SplitEntry(line, entryKey, entryValue) && EqualsIgnoreCase(entryKey, key))
+            {
+                result = entryValue;
+                break;
+            }
+        }
+    }
+    if (0 == size)
+    {
+        return 0;
+    }
+    const size_t length = std::min(result.size(), static_cast<size_t>(size - 1));
+    memcpy(buffer, result.c_str(), length);
+    buffer[length] = '\0';
+    return static_cast<DWORD>(length);
+}
+
+BOOL WritePrivateProfileString(LPCSTR section, LPCSTR key, LPCSTR value, LPCSTR file)
+{
+    std::vector<std::string> lines;
+    ReadLines(file, lines);
+
+    const std::string entry = std::string(key) + "=" + value;
+    bool inSection{false}, replaced{false};
+    std::optional<size_t> sectionEnd{};
+    for (size_t i = 0; i < lines.size() && !replaced; i++)
+    {
+        if (const std::string current = SectionOf(lines[i]); !current.empty())
+        {
+            inSection = EqualsIgnoreCase(current, section);
+            if (inSection && !sectionEnd)
+            {
+                sectionEnd = i + 1;
+            }
+            continue;
+        }
+        if (inSection)
+        {
+            if (std::string entryKey, entryValue;
+                SplitEntry(lines[i], entryKey, entryValue) && EqualsIgnoreCase(entryKey, key))
+            {
+                lines[i] = entry;
+                replaced = true;
+            }
+            else if (!Trim(lines[i]).empty())
+            {
+                sectionEnd = i + 1;
+            }
+        }
+    }
+    if (!replaced && sectionEnd)
+    {
+        // append to the existing section
+        lines.insert(lines.begin() + static_cast<std::ptrdiff_t>(*sectionEnd), entry);
+    }
+    else if (!replaced)
+    {
+        lines.push_back(std::string("[") + section + "]");
+        lines.push_back(entry);
+    }
+
+    std::ofstream stream(file, std::ios_base::trunc);
+    for (const std::string& line : lines)
+    {
+        stream << line << "\n";
+    }
+    return stream.good() ? TRUE : FALSE;
+}
+
+int _access(const char* path, const int mode)
+{
+    return access(path, mode);
+}
+
+int vsnprintf_s(char* buffer, const size_t size, size_t, const char* format, va_list args)
+{
+    const int length = vsnprintf(buffer, size, format, args);
+    return length >= 0 && static_cast<size_t>(length) < size ? length : -1;
+}
+
+BOOL PlaySound(LPCSTR, HMODULE, DWORD)
+{
+    return TRUE;
+}
@@ -0,0 +1,86 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "test_config.h"
+
+TEST_F(ConfigTest, DefaultConfigurationContainsAllKeys)
+{
+    ASSERT_TRUE(Load());
+
+    float strength{};
+    EXPECT_TRUE(GetConfig()->GetFloat(Cfg::TransStrength, strength));
+    EXPECT_FLOAT_EQ(0.5f, strength);
+    int order{};
+    EXPECT_TRUE(GetConfig()->GetInt(Cfg::TransOrder, order));
+    EXPECT_EQ(2, order);
+    bool enabled{true};
+    EXPECT_TRUE(GetConfig()->GetBool(Cfg::StabilizerEnabled, enabled));
+    EXPECT_FALSE(enabled);
+}
+
+TEST_F(ConfigTest, ApplicationConfigurationIsCreated)
+{
+    ASSERT_FALSE(std::filesystem::exists(AppConfig()));
+    ASSERT_TRUE(Load());
+    EXPECT_TRUE(std::filesystem::exists(AppConfig()));
+
+    char buffer[16];
+    EXPECT_EQ(1u, GetPrivateProfileString("startup", "enabled", nullptr, buffer, 16, AppConfig().string().c_str()));
+    EXPECT_STREQ("1", buffer);
+}
+
+TEST_F(ConfigTest, ApplicationValueOverridesDefault)
+{
+    Override("translation_filter", "strength", "0.25");
+    Override("rotation_filter", "order", "3");
+    ASSERT_TRUE(Load());
+
+    float strength{};
+    EXPECT_TRUE(GetConfig()->GetFloat(Cfg::TransStrength, strength));
+    EXPECT_FLOAT_EQ(0.25f, strength);
+    int order{};
+    EXPECT_TRUE(GetConfig()->GetInt(Cfg::RotOrder, order));
+    EXPECT_EQ(3, order);
+    EXPECT_TRUE(GetConfig()->GetFloat(Cfg::RotStrength, strength));
+    EXPECT_FLOAT_EQ(0.5f, strength);
+}
+
+TEST_F(ConfigTest, InvalidNumberIsRejected)
+{
+    Override("translation_filter", "strength", "strong");
+    Override("translation_filter", "order", "second");
+    ASSERT_TRUE(Load());
+
+    float strength{-1.f};
+    EXPECT_FALSE(GetConfig()->GetFloat(Cfg::TransStrength, strength));
+    EXPECT_FLOAT_EQ(-1.f, strength);
+    int order{-1};
+    EXPECT_FALSE(GetConfig()->GetInt(Cfg::TransOrder, order));
+    EXPECT_EQ(-1, order);
+}
+
+TEST_F(ConfigTest, ShortcutIsParsed)
+{
+    Override("shortcuts", "activate", "CTRL+SHIFT+F1");
+    Override("shortcuts", "calibrate", "CTRL+NOSUCHKEY");
+    ASSERT_TRUE(Load());
+
+    std::set<int> keys;
+    EXPECT_TRUE(GetConfig()->GetShortcut(Cfg::KeyActivate, keys));
+    EXPECT_EQ((std::set<int>{VK_CONTROL, VK_SHIFT, VK_F1}), keys);
+
+    keys.clear();
+    EXPECT_FALSE(GetConfig()->GetShortcut(Cfg::KeyCalibrate, keys));
+}
+
+TEST_F(ConfigTest, SavedValueIsReloaded)
+{
+    ASSERT_TRUE(Load());
+    GetConfig()->SetValue(Cfg::TransStrength, 0.75f);
+    GetConfig()->WriteConfig(true);
+
+    GetConfig()->SetValue(Cfg::TransStrength, 0.f);
+    ASSERT_TRUE(Load());
+    float strength{};
+    EXPECT_TRUE(GetConfig()->GetFloat(Cfg::TransStrength, strength));
+    EXPECT_FLOAT_EQ(0.75f, strength);
+}
@@ -0,0 +1,189 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "test_config.h"
+#include "reference_filters.h"
+#include "filter.h"
+
+using namespace filter;
+using namespace utility;
+using namespace xr::math;
+
+namespace
+{
+    constexpr XrTime frameInterval{1000000000 / 90};
+
+    // rotation angle between two quaternions, calculated in double precision
+    double AngleBetween(const XrQuaternionf& a, const XrQuaternionf& b)
+    {
+        const double w = static_cast<double>(a.w) * b.w + static_cast<double>(a.x) * b.x +
+                         static_cast<double>(a.y) * b.y + static_cast<double>(a.z) * b.z;
+        const double x = static_cast<double>(a.w) * b.x - static_cast<double>(a.x) * b.w -
+                         static_cast<double>(a.y) * b.z + static_cast<double>(a.z) * b.y;
+        const double y = static_cast<double>(a.w) * b.y + static_cast<double>(a.x) * b.z -
+                         static_cast<double>(a.y) * b.w - static_cast<double>(a.z) * b.x;
+        const double z = static_cast<double>(a.w) * b.z - static_cast<double>(a.x) * b.y +
+                         static_cast<double>(a.y) * b.x - static_cast<double>(a.z) * b.w;
+        return 2.0 * std::atan2(std::sqrt(x * x + y * y + z * z), std::abs(w));
+    }
+
+    XrQuaternionf RandomRotation(std::mt19937& random, const float maxAngle)
+    {
+        std::normal_distribution<float> normal;
+        std::uniform_real_distribution<float> uniform(0.f, maxAngle);
+        XrVector3f axis{normal(random), normal(random), normal(random)};
+        XrQuaternionf rotation;
+        StoreXrQuaternion(&rotation, DirectX::XMQuaternionRotationAxis(LoadXrVector3(axis), uniform(random)));
+        return rotation;
+    }
+} // namespace
+
+class EquivalenceTest : public ConfigTest
+{
+  protected:
+    void SetUp() override
+    {
+        ConfigTest::SetUp();
+        ASSERT_TRUE(Load());
+    }
+};
+
+template <size_t Order>
+static void CompareEma(const float strength, const float verticalFactor)
+{
+    EmaFilter<Order> vectorized(strength);
+    reference::ScalarEma<Order> scalar(strength, verticalFactor);
+    vectorized.Reset({0.f, 1.f, 2.f});
+    scalar.Reset({0.f, 1.f, 2.f});
+
+    std::mt19937 random(Order);
+    std::uniform_real_distribution<float> step(-0.01f, 0.01f);
+    XrVector3f input{0.f, 1.f, 2.f};
+    for (int i = 1; i <= 10000; i++)
+    {
+        input = {input.x + step(random), input.y + step(random), input.z + step(random)};
+        XrVector3f a = input, b = input;
+        vectorized.Filter(a, i * frameInterval);
+        scalar.Filter(b);
+        ASSERT_NEAR(b.x, a.x, 1e-5f) << "order " << Order << ", sample " << i;
+        ASSERT_NEAR(b.y, a.y, 1e-5f) << "order " << Order << ", sample " << i;
+        ASSERT_NEAR(b.z, a.z, 1e-5f) << "order " << Order << ", sample " << i;
+    }
+}
+
+TEST_F(EquivalenceTest, VectorizedEmaMatchesScalar)
+{
+    CompareEma<1>(0.6f, 1.f);
+    CompareEma<2>(0.6f, 1.f);
+    CompareEma<3>(0.6f, 1.f);
+}
+
+TEST_F(EquivalenceTest, VectorizedEmaMatchesScalarWithVerticalFactor)
+{
+    Override("translation_filter", "vertical_factor", "1.5");
+    ASSERT_TRUE(Load());
+    CompareEma<1>(0.5f, 1.5f);
+    CompareEma<2>(0.5f, 1.5f);
+    CompareEma<3>(0.5f, 1.5f);
+}
+
+TEST_F(EquivalenceTest, NlerpErrorBound)
+{
+    // single interpolation step with rotational differences up to the threshold of 10 degrees
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> strength(0.01f, 0.99f);
+    double maxError{0.0};
+    for (int i = 0; i < 100000; i++)
+    {
+        const XrQuaternionf from = RandomRotation(random, floatPi);
+        XrQuaternionf to;
+        StoreXrQuaternion(&to,
+                          DirectX::XMQuaternionMultiply(LoadXrQuaternion(from),
+                                                        LoadXrQuaternion(RandomRotation(random, 9.99f * angleToRadian))));
+        const float alpha = strength(random);
+
+        SlerpFilter<1> fast(alpha);
+        fast.Reset(from);
+        XrQuaternionf result = to;
+        fast.Filter(result, frameInterval);
+        maxError = std::max(maxError, AngleBetween(Quaternion::Slerp(to, from, alpha), result));
+    }
+    EXPECT_LT(maxError, 2.2e-5);
+}
+
+TEST_F(EquivalenceTest, FastSlerpFilterMatchesExact)
+{
+    SlerpFilter<3> fast(0.7f);
+    reference::ExactSlerp<3> exact(0.7f);
+    fast.Reset(Quaternion::Identity());
+    exact.Reset(Quaternion::Identity());
+
+    // random walk with per frame differences up to 2 degrees, larger jumps use slerp in both filters
+    std::mt19937 random(7);
+    XrQuaternionf input = Quaternion::Identity();
+    for (int i = 1; i <= 10000; i++)
+    {
+        const float maxStep = i % 1000 ? 2.f * angleToRadian : floatPi / 2.f;
+        StoreXrQuaternion(&input,
+                          DirectX::XMQuaternionNormalize(DirectX::XMQuaternionMultiply(
+                              LoadXrQuaternion(input), LoadXrQuaternion(RandomRotation(random, maxStep)))));
+        XrQuaternionf a = input, b = input;
+        fast.Filter(a, i * frameInterval);
+        exact.Filter(b);
+        ASSERT_LT(AngleBetween(a, b), 1e-4) << "sample " << i;
+    }
+}
+
+template <size_t Sections>
+static void CompareBiQuad(const std::array<float, 6>& cutoff, const std::array<float, 6>& notch)
+{
+    const std::vector<DofValue> relevant{sway, surge, heave, yaw, roll, pitch};
+    float bandwidth{};
+    GetConfig()->GetFloat(Cfg::StabilizerNotchBandwidth, bandwidth);
+
+    BiQuadStabilizer<Sections> soa(relevant);
+    soa.SetStrength(0.5f);
+    std::vector<reference::ScalarBiQuad> scalar;
+    for (const DofValue value : relevant)
+    {
+        soa.SetCutoff(value, cutoff[value]);
+        scalar.emplace_back(Sections, 1000.0, cutoff[value], notch[value], bandwidth);
+    }
+
+    constexpr int64_t interval{1000000};
+    soa.SetStartTime(interval);
+    for (int i = 0; i < 5000; i++)
+    {
+        Dof dof{};
+        for (size_t v = 0; v < 6; v++)
+        {
+            const float t = static_cast<float>(i) / 1000.f;
+            dof.data[v] = 1.f + std::sin(2.f * floatPi * (0.5f + v) * t) + 0.3f * std::sin(2.f * floatPi * 40.f * t);
+        }
+        Dof output{};
+        Dof input = dof;
+        soa.Insert(input, (i + 2) * interval);
+        soa.Read(output);
+        for (size_t v = 0; v < 6; v++)
+        {
+            const float expected = static_cast<float>(scalar[v].Filter(dof.data[v]));
+            ASSERT_NEAR(expected, output.data[v], 1e-5f) << "dof " << v << ", sample " << i;
+        }
+    }
+}
+
+TEST_F(EquivalenceTest, StructureOfArraysBiQuadMatchesScalar)
+{
+    const std::array<float, 6> cutoff{2.f, 3.f, 4.f, 5.f, 6.f, 7.f};
+    CompareBiQuad<1>(cutoff, {});
+    CompareBiQuad<2>(cutoff, {});
+}
+
+TEST_F(EquivalenceTest, StructureOfArraysBiQuadWithNotchMatchesScalar)
+{
+    Override("input_stabilizer", "notch_surge", "40.0");
+    Override("input_stabilizer", "notch_pitch", "25.0");
+    ASSERT_TRUE(Load());
+    const std::array<float, 6> cutoff{2.f, 3.f, 4.f, 5.f, 6.f, 7.f};
+    CompareBiQuad<1>(cutoff, {0.f, 40.f, 0.f, 0.f, 0.f, 25.f});
+    CompareBiQuad<2>(cutoff, {0.f, 40.f, 0.f, 0.f, 0.f, 25.f});
+}
@@ -0,0 +1,464 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "test_config.h"
+#include "filter.h"
+
+using namespace filter;
+using namespace utility;
+using namespace xr::math;
+
+namespace
+{
+    constexpr XrTime frameInterval{1000000000 / 90};
+
+    float Angle(const XrQuaternionf& rotation)
+    {
+        return 2.f * std::acos(std::min(1.f, std::abs(rotation.w)));
+    }
+
+    XrQuaternionf Yaw(const float angle)
+    {
+        return {0.f, std::sin(angle / 2.f), 0.f, std::cos(angle / 2.f)};
+    }
+
+    // peak output of the last second of a sine wave sampled at 1 kHz
+    template <typename Stabilizer>
+    float Amplitude(Stabilizer& stabilizer, const float frequency)
+    {
+        constexpr int64_t interval{1000000};
+        constexpr int samples{3000};
+        stabilizer.SetStartTime(interval);
+        float peak{0.f};
+        for (int i = 0; i < samples; i++)
+        {
+            Dof dof{};
+            dof.data[sway] = std::sin(2.f * floatPi * frequency * static_cast<float>(i) / 1000.f);
+            stabilizer.Insert(dof, (i + 2) * interval);
+            Dof output{};
+            stabilizer.Read(output);
+            if (i >= samples - 1000)
+            {
+                peak = std::max(peak, std::abs(output.data[sway]));
+            }
+        }
+        return peak;
+    }
+} // namespace
+
+class FilterTest : public ConfigTest
+{
+  protected:
+    void SetUp() override
+    {
+        ConfigTest::SetUp();
+        ASSERT_TRUE(Load());
+    }
+};
+
+TEST_F(FilterTest, EmaFirstOrderStep)
+{
+    EmaFilter<1> ema(0.5f);
+    ema.Reset({0.f, 0.f, 0.f});
+    XrVector3f location{1.f, 2.f, 3.f};
+    ema.Filter(location, frameInterval);
+    EXPECT_FLOAT_EQ(0.5f, location.x);
+    EXPECT_FLOAT_EQ(1.0f, location.y);
+    EXPECT_FLOAT_EQ(1.5f, location.z);
+}
+
+TEST_F(FilterTest, EmaVerticalFactor)
+{
+    Override("translation_filter", "vertical_factor", "0.0");
+    ASSERT_TRUE(Load());
+    EmaFilter<1> ema(0.5f);
+    ema.Reset({0.f, 0.f, 0.f});
+    XrVector3f location{1.f, 1.f, 1.f};
+    ema.Filter(location, frameInterval);
+    EXPECT_FLOAT_EQ(0.5f, location.x);
+    EXPECT_FLOAT_EQ(1.0f, location.y);
+}
+
+TEST_F(FilterTest, EmaZeroStrengthPassesThrough)
+{
+    EmaFilter<3> ema(0.f);
+    ema.Reset({0.f, 0.f, 0.f});
+    XrVector3f location{1.f, 2.f, 3.f};
+    ema.Filter(location, frameInterval);
+    EXPECT_FLOAT_EQ(1.f, location.x);
+    EXPECT_FLOAT_EQ(2.f, location.y);
+    EXPECT_FLOAT_EQ(3.f, location.z);
+}
+
+TEST_F(FilterTest, EmaHigherOrderReducesLag)
+{
+    EmaFilter<1> first(0.8f);
+    EmaFilter<2> second(0.8f);
+    EmaFilter<3> third(0.8f);
+    first.Reset({0.f, 0.f, 0.f});
+    second.Reset({0.f, 0.f, 0.f});
+    third.Reset({0.f, 0.f, 0.f});
+    XrVector3f a{}, b{}, c{};
+    constexpr float slope{0.01f};
+    float input{0.f};
+    for (int i = 1; i <= 500; i++)
+    {
+        input = slope * static_cast<float>(i);
+        a = b = c = {input, input, input};
+        first.Filter(a, i * frameInterval);
+        second.Filter(b, i * frameInterval);
+        third.Filter(c, i * frameInterval);
+    }
+    // steady state lag of a single ema stage on a ramp: slope * strength / (1 - strength)
+    EXPECT_NEAR(slope * 4.f, input - a.x, 1e-4f);
+    EXPECT_NEAR(0.f, input - b.x, 1e-4f);
+    EXPECT_NEAR(0.f, input - c.x, 1e-4f);
+}
+
+TEST_F(FilterTest, EmaTimeBasedIsRateIndependent)
+{
+    EmaFilter<1> slow(0.5f);
+    EmaFilter<1> fast(0.5f);
+    slow.SetTimeBased(true);
+    fast.SetTimeBased(true);
+    slow.Reset({0.f, 0.f, 0.f});
+    fast.Reset({0.f, 0.f, 0.f});
+    // the first sample only provides the start time
+    XrVector3f a{}, b{};
+    slow.Filter(a, frameInterval);
+    fast.Filter(b, frameInterval);
+    for (int i = 1; i <= 5; i++)
+    {
+        a = {1.f, 1.f, 1.f};
+        slow.Filter(a, (i + 1) * frameInterval);
+    }
+    for (int i = 1; i <= 10; i++)
+    {
+        b = {1.f, 1.f, 1.f};
+        fast.Filter(b, frameInterval + i * frameInterval / 2);
+    }
+    EXPECT_NEAR(1.f - std::pow(0.5f, 5.f), a.x, 1e-5f);
+    EXPECT_NEAR(a.x, b.x, 1e-4f);
+}
+
+TEST_F(FilterTest, SlerpFirstOrderHalfway)
+{
+    SlerpFilter<1> slerp(0.5f);
+    slerp.Reset(Quaternion::Identity());
+    XrQuaternionf rotation = Yaw(floatPi / 2.f);
+    slerp.Filter(rotation, frameInterval);
+    EXPECT_NEAR(floatPi / 4.f, Angle(rotation), 1e-5f);
+}
+
+TEST_F(FilterTest, SlerpConvergesAndStaysNormalized)
+{
+    SlerpFilter<3> slerp(0.7f);
+    slerp.Reset(Quaternion::Identity());
+    XrQuaternionf rotation{};
+    for (int i = 1; i <= 300; i++)
+    {
+        rotation = Yaw(0.3f);
+        slerp.Filter(rotation, i * frameInterval);
+        const float norm = rotation.x * rotation.x + rotation.y * rotation.y + rotation.z * rotation.z +
+                           rotation.w * rotation.w;
+        ASSERT_NEAR(1.f, norm, 1e-5f);
+    }
+    EXPECT_NEAR(0.3f, Angle(rotation), 1e-4f);
+}
+
+TEST_F(FilterTest, OneEuroFollowsFastMotion)
+{
+    Override("translation_filter", "one_euro_beta", "0.0");
+    ASSERT_TRUE(Load());
+    OneEuroFilter<XrVector3f> fixed(0.9f);
+    Override("translation_filter", "one_euro_beta", "100.0");
+    ASSERT_TRUE(Load());
+    OneEuroFilter<XrVector3f> adaptive(0.9f);
+
+    XrVector3f a{}, b{};
+    for (int i = 1; i <= 10; i++)
+    {
+        const float input = i > 1 ? 1.f : 0.f;
+        a = b = {input, 0.f, 0.f};
+        fixed.Filter(a, i * frameInterval);
+        adaptive.Filter(b, i * frameInterval);
+        ASSERT_LE(a.x, 1.f);
+        ASSERT_LE(b.x, 1.f);
+    }
+    // higher beta raises the cutoff while moving
+    EXPECT_GT(b.x, a.x);
+    EXPECT_GT(a.x, 0.f);
+}
+
+TEST_F(FilterTest, OneEuroKeepsConstantValue)
+{
+    OneEuroFilter<XrQuaternionf> euro(0.9f);
+    XrQuaternionf rotation{};
+    for (int i = 1; i <= 100; i++)
+    {
+        rotation = Yaw(0.5f);
+        euro.Filter(rotation, i * frameInterval);
+    }
+    EXPECT_NEAR(0.5f, Angle(rotation), 1e-5f);
+}
+
+TEST_F(FilterTest, KalmanTracksConstantVelocity)
+{
+    KalmanFilter<XrVector3f> kalman(0.5f);
+    XrVector3f location{};
+    constexpr float velocity{0.9f};
+    float input{0.f};
+    for (int i = 1; i <= 900; i++)
+    {
+        input = velocity * static_cast<float>(i) / 90.f;
+        location = {input, 0.f, -input};
+        kalman.Filter(location, i * frameInterval);
+    }
+    // constant velocity model doesn't lag behind linear motion
+    EXPECT_NEAR(input, location.x, 1e-3f);
+    EXPECT_NEAR(-input, location.z, 1e-3f);
+}
+
+TEST_F(FilterTest, KalmanTracksConstantRotation)
+{
+    KalmanFilter<XrQuaternionf> kalman(0.5f);
+    XrQuaternionf rotation{};
+    float angle{0.f};
+    for (int i = 1; i <= 180; i++)
+    {
+        angle = 0.5f * static_cast<float>(i) / 90.f;
+        rotation = Yaw(angle);
+        kalman.Filter(rotation, i * frameInterval);
+    }
+    EXPECT_NEAR(angle, Angle(rotation), 1e-3f);
+}
+
+TEST_F(FilterTest, SetOrderSelectsAlternative)
+{
+    TransFilter trans{};
+    SetOrder<EmaFilter>(trans, 3, 0.5f);
+    EXPECT_TRUE(std::holds_alternative<EmaFilter<3>>(trans));
+    RotFilter rot{};
+    SetOrder<SlerpFilter>(rot, 1, 0.5f);
+    EXPECT_TRUE(std::holds_alternative<SlerpFilter<1>>(rot));
+}
+
+class BiQuadTest : public FilterTest
+{
+  protected:
+    const std::vector<DofValue> relevant{sway, surge, heave, yaw, roll, pitch};
+};
+
+TEST_F(BiQuadTest, UnityGainAtZeroFrequency)
+{
+    BiQuadStabilizer<2> biquad(relevant);
+    biquad.SetStrength(0.5f);
+    biquad.SetStartTime(1000000);
+    Dof output{};
+    for (int i = 0; i < 2000; i++)
+    {
+        Dof dof{};
+        std::ranges::fill(dof.data, i > 0 ? 1.f : 0.f);
+        biquad.Insert(dof, (i + 2) * 1000000ll);
+        biquad.Read(output);
+    }
+    for (const float value : output.data)
+    {
+        EXPECT_NEAR(1.f, value, 1e-5f);
+    }
+}
+
+TEST_F(BiQuadTest, AttenuatesHighFrequencies)
+{
+    BiQuadStabilizer<1> biquad(relevant);
+    biquad.SetStrength(0.5f);
+
+    EXPECT_GT(Amplitude(biquad, 0.5f), 0.95f);
+    EXPECT_LT(Amplitude(biquad, 100.f), 0.01f);
+}
+
+TEST_F(BiQuadTest, ButterworthGainAtCutoff)
+{
+    BiQuadStabilizer<1> second(relevant);
+    BiQuadStabilizer<2> fourth(relevant);
+    second.SetStrength(0.5f);
+    fourth.SetStrength(0.5f);
+    second.SetCutoff(sway, 10.f);
+    fourth.SetCutoff(sway, 10.f);
+
+    // bilinear transform with prewarping places -3 dB exactly at the cutoff frequency
+    EXPECT_NEAR(std::sqrt(0.5f), Amplitude(second, 10.f), 0.01f);
+    EXPECT_NEAR(std::sqrt(0.5f), Amplitude(fourth, 10.f), 0.01f);
+}
+
+TEST_F(BiQuadTest, HigherOrderAttenuatesMore)
+{
+    BiQuadStabilizer<1> second(relevant);
+    BiQuadStabilizer<2> fourth(relevant);
+    second.SetStrength(0.5f);
+    fourth.SetStrength(0.5f);
+
+    EXPECT_GT(Amplitude(second, 1.f), 0.95f);
+    EXPECT_GT(Amplitude(fourth, 1.f), 0.95f);
+    const float attenuatedSecond = Amplitude(second, 100.f);
+    const float attenuatedFourth = Amplitude(fourth, 100.f);
+    EXPECT_LT(attenuatedSecond, 0.01f);
+    EXPECT_LT(attenuatedFourth, attenuatedSecond / 10.f);
+}
+
+TEST_F(BiQuadTest, NotchWithoutLowPass)
+{
+    Override("input_stabilizer", "notch_sway", "20.0");
+    ASSERT_TRUE(Load());
+    BiQuadStabilizer<1> biquad(relevant);
+    biquad.SetStrength(0.f);
+
+    EXPECT_LT(Amplitude(biquad, 20.f), 0.02f);
+    EXPECT_GT(Amplitude(biquad, 5.f), 0.95f);
+    EXPECT_GT(Amplitude(biquad, 60.f), 0.95f);
+}
+
+TEST_F(BiQuadTest, SamplingRateChangeKeepsConstantInput)
+{
+    BiQuadStabilizer<2> biquad(relevant);
+    biquad.SetStrength(0.5f);
+    int64_t time{1000000};
+    biquad.SetStartTime(time);
+    // measured sampling frequency drifts and stalls, recalculating the coefficients several times
+    for (int i = 0; i < 3000; i++)
+    {
+        time += i < 1000 ? 1020000 : i % 4 ? 1000000 : 4000000;
+        Dof dof{{10.f, 20.f, 30.f, 40.f, 50.f, 60.f}};
+        biquad.Insert(dof, time);
+        Dof output{};
+        biquad.Read(output);
+        for (const DofValue value : relevant)
+        {
+            ASSERT_NEAR(dof.data[value], output.data[value], 1e-4f) << "dof " << value << ", sample " << i;
+        }
+    }
+}
+
+TEST_F(BiQuadTest, CutoffChangeKeepsConstantInput)
+{
+    BiQuadStabilizer<2> biquad(relevant);
+    biquad.SetStrength(0.5f);
+    biquad.SetStartTime(1000000);
+    Dof output{};
+    for (int i = 0; i < 200; i++)
+    {
+        if (100 == i)
+        {
+            biquad.SetCutoff(yaw, 1.f);
+            biquad.SetCutoff(sway, 15.f);
+        }
+        Dof dof{{10.f, 20.f, 30.f, 90.f, 50.f, 60.f}};
+        biquad.Insert(dof, (i + 2) * 1000000ll);
+        biquad.Read(output);
+        for (const DofValue value : relevant)
+        {
+            ASSERT_NEAR(dof.data[value], output.data[value], 1e-4f) << "dof " << value << ", sample " << i;
+        }
+    }
+}
+
+TEST_F(BiQuadTest, CutoffIgnoredForExcludedDof)
+{
+    Override("input_stabilizer", "yaw", "0.0");
+    ASSERT_TRUE(Load());
+    BiQuadStabilizer<2> biquad(relevant);
+    biquad.SetStrength(0.5f);
+    biquad.SetCutoff(yaw, 1.f);
+    biquad.SetStartTime(1000000);
+    Dof output{};
+    for (int i = 0; i < 10; i++)
+    {
+        Dof dof{};
+        dof.data[yaw] = i > 0 ? 30.f : 0.f;
+        biquad.Insert(dof, (i + 2) * 1000000ll);
+        biquad.Read(output);
+        EXPECT_FLOAT_EQ(dof.data[yaw], output.data[yaw]) << "sample " << i;
+    }
+}
+
+// feeds a sine with added white noise into the analyzer until an analysis is completed or the samples are used up
+bool AnalyzeCutoff(CutoffAnalyzer& analyzer,
+                   const float frequency,
+                   const float noise,
+                   const int64_t interval,
+                   const int samples,
+                   float& cutoff)
+{
+    std::mt19937 generator(42);
+    std::normal_distribution<float> distribution(0.f, noise);
+    for (int i = 0; i < samples; i++)
+    {
+        const int64_t time = (i + 1) * interval;
+        Dof dof{};
+        dof.data[roll] = 10.f * std::sin(2.f * floatPi * frequency * static_cast<float>(time) / 1e9f) +
+                         distribution(generator);
+        if (DofValue value; analyzer.Add(dof, time, value, cutoff))
+        {
+            EXPECT_EQ(roll, value);
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST_F(FilterTest, CutoffAnalyzerFindsMotionBand)
+{
+    // 1 Hz motion sampled at 1 kHz, cutoff is placed 1.5 times above the band edge
+    CutoffAnalyzer analyzer({roll});
+    float cutoff{0.f};
+    ASSERT_TRUE(AnalyzeCutoff(analyzer, 1.f, 0.5f, 1000000, 20000, cutoff));
+    EXPECT_NEAR(1.5f, cutoff, 0.4f);
+}
+
+TEST_F(FilterTest, CutoffAnalyzerIgnoresNoise)
+{
+    CutoffAnalyzer analyzer({roll});
+    float cutoff{0.f};
+    EXPECT_FALSE(AnalyzeCutoff(analyzer, 0.f, 0.5f, 1000000, 40000, cutoff));
+}
+
+TEST_F(FilterTest, CutoffAnalyzerRequiresNoiseBand)
+{
+    // 100 Hz sampling rate is decimated to 25 Hz, which doesn't cover the noise band starting at 20 Hz
+    CutoffAnalyzer analyzer({roll});
+    float cutoff{0.f};
+    EXPECT_FALSE(AnalyzeCutoff(analyzer, 1.f, 0.5f, 10000000, 20000, cutoff));
+}
+
+TEST(SampleSeqLockTest, ConcurrentReadsAreConsistent)
+{
+    SampleSeqLock handoff;
+    handoff.Store(Dof{});
+
+    // all values of a write are equal, a torn read would mix values of consecutive writes
+    constexpr int writes{200000};
+    std::atomic_bool done{false};
+    std::thread writer([&handoff, &done] {
+        for (int i = 1; i <= writes; i++)
+        {
+            const float value = static_cast<float>(i);
+            handoff.Store(Dof{{value, value, value, value, value, value}});
+        }
+        done = true;
+    });
+    float previous{0.f};
+    while (!done.load())
+    {
+        Dof read{};
+        handoff.Load(read);
+        for (size_t i = 1; i < 6; i++)
+        {
+            ASSERT_EQ(read.data[0], read.data[i]);
+        }
+        ASSERT_GE(read.data[0], previous);
+        previous = read.data[0];
+    }
+    writer.join();
+    Dof last{};
+    handoff.Load(last);
+    EXPECT_EQ(static_cast<float>(writes), last.data[0]);
+}
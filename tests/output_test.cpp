@@ -0,0 +1,72 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "pch.h"
+#include "output.h"
+#include <gtest/gtest.h>
+
+using namespace output;
+using namespace utility;
+
+namespace
+{
+    constexpr int64_t interval{10000000};
+
+    // sine motion on all dofs, filtered values delayed by the given number of samples
+    std::vector<EvaluationSample> DelayedSine(const size_t count, const size_t delay, const float offset)
+    {
+        std::vector<EvaluationSample> samples(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto value = [offset](const int64_t index) {
+                return offset + 10.f * std::sin(2.f * floatPi * 0.5f * static_cast<float>(index) / 100.f);
+            };
+            const float input = value(static_cast<int64_t>(i));
+            const float output = value(static_cast<int64_t>(i) - static_cast<int64_t>(delay));
+            samples[i] = {static_cast<int64_t>(i) * interval,
+                          {{input, input, input, input, input, input}},
+                          {{output, output, output, output, output, output}}};
+        }
+        return samples;
+    }
+} // namespace
+
+TEST(EvaluationTest, TooFewSamples)
+{
+    Evaluation result;
+    EXPECT_FALSE(EvaluateSamples(DelayedSine(15, 0, 0.f), result));
+}
+
+TEST(EvaluationTest, DetectsLag)
+{
+    Evaluation result;
+    ASSERT_TRUE(EvaluateSamples(DelayedSine(1000, 7, 0.f), result));
+    EXPECT_DOUBLE_EQ(static_cast<double>(interval), result.interval);
+    for (int dof = 0; dof < 6; dof++)
+    {
+        EXPECT_DOUBLE_EQ(7.0 * interval, result.lag[dof]) << "dof " << dof;
+        EXPECT_GT(result.correlation[dof], 0.9) << "dof " << dof;
+        EXPECT_NEAR(result.inputJitter[dof], result.outputJitter[dof], 0.01 * result.inputJitter[dof]);
+    }
+}
+
+TEST(EvaluationTest, UnwrapsAngles)
+{
+    // oscillation around 180 degrees wraps to -180 in the recorded angles
+    std::vector<EvaluationSample> samples = DelayedSine(1000, 3, 175.f);
+    for (EvaluationSample& sample : samples)
+    {
+        for (int dof = yaw; dof <= pitch; dof++)
+        {
+            sample.unfiltered.data[dof] = fmod(sample.unfiltered.data[dof] + 180.f, 360.f) - 180.f;
+            sample.filtered.data[dof] = fmod(sample.filtered.data[dof] + 180.f, 360.f) - 180.f;
+        }
+    }
+    Evaluation result;
+    ASSERT_TRUE(EvaluateSamples(samples, result));
+    for (int dof = yaw; dof <= pitch; dof++)
+    {
+        EXPECT_DOUBLE_EQ(3.0 * interval, result.lag[dof]) << "dof " << dof;
+        EXPECT_LT(result.inputJitter[dof], 0.1) << "dof " << dof;
+        EXPECT_LT(result.outputJitter[dof], 0.1) << "dof " << dof;
+    }
+}
@@ -0,0 +1,452 @@
+// Copyright(c) 2024 Sebastian Veith
+
+// micro benchmarks of the per frame pose pipeline (as executed in OpenXrLayer::xrLocateViews) and its filters
+// every benchmark iteration processes one frame / sample, allocations are counted by replacing the global
+// allocation functions
+
+#include "pch.h"
+#include "config.h"
+#include "filter.h"
+#include "modifier.h"
+#include "reference_filters.h"
+#include <util.h>
+#include <benchmark/benchmark.h>
+
+using namespace filter;
+using namespace utility;
+using namespace xr::math;
+
+namespace
+{
+    std::atomic<uint64_t> g_Allocations{0};
+
+    constexpr XrTime frameInterval{1000000000 / 90};
+
+    // synthetic tracker input: slow rig motion with some vibration
+    // precalculated to keep the generation out of the measurement
+    const std::vector<XrPosef> g_TrackerPoses = [] {
+        std::vector<XrPosef> poses(4096);
+        for (size_t frame = 0; frame < poses.size(); frame++)
+        {
+            const float t = static_cast<float>(frame) / 90.f;
+            poses[frame].position = {0.05f * std::sin(0.5f * t),
+                                     0.8f + 0.02f * std::sin(13.f * t),
+                                     0.1f * std::sin(0.3f * t)};
+            StoreXrQuaternion(&poses[frame].orientation,
+                              DirectX::XMQuaternionRotationRollPitchYaw(0.1f * std::sin(0.4f * t),
+                                                                        0.2f * std::sin(0.2f * t),
+                                                                        0.05f * std::sin(17.f * t)));
+        }
+        return poses;
+    }();
+
+    const XrPosef& TrackerPose(const int64_t frame)
+    {
+        return g_TrackerPoses[static_cast<size_t>(frame) % g_TrackerPoses.size()];
+    }
+
+    // execute one frame per iteration and report time and allocations per frame
+    template <typename Frame>
+    void Run(benchmark::State& state, Frame&& frame)
+    {
+        int64_t count{0};
+        const uint64_t allocations = g_Allocations.load(std::memory_order_relaxed);
+        for (auto _ : state)
+        {
+            frame(++count);
+        }
+        state.counters["allocs/frame"] =
+            benchmark::Counter(static_cast<double>(g_Allocations.load(std::memory_order_relaxed) - allocations),
+                               benchmark::Counter::kAvgIterations);
+        state.counters["time/sample"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                           benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    }
+
+    // filter order 1 - 3 selects ema / slerp stages, 4 = one euro, 5 = kalman
+    void CreateFilters(const int64_t type, TransFilter& trans, RotFilter& rot)
+    {
+        switch (type)
+        {
+        case 4:
+            trans.emplace<OneEuroFilter<XrVector3f>>(0.5f);
+            rot.emplace<OneEuroFilter<XrQuaternionf>>(0.5f);
+            break;
+        case 5:
+            trans.emplace<KalmanFilter<XrVector3f>>(0.5f);
+            rot.emplace<KalmanFilter<XrQuaternionf>>(0.5f);
+            break;
+        default:
+            SetOrder<EmaFilter>(trans, static_cast<int>(type), 0.5f);
+            SetOrder<SlerpFilter>(rot, static_cast<int>(type), 0.5f);
+            break;
+        }
+    }
+
+    void ApplyFilters(TransFilter& trans, RotFilter& rot, XrPosef& pose, const XrTime time)
+    {
+        std::visit([&pose, time](auto& filter) { filter.Filter(pose.position, time); }, trans);
+        std::visit([&pose, time](auto& filter) { filter.Filter(pose.orientation, time); }, rot);
+    }
+
+    // per frame pipeline state of tracker, layer and modifiers
+    struct Pipeline
+    {
+        explicit Pipeline(const int64_t transType, const int64_t rotType)
+        {
+            TransFilter unused{};
+            RotFilter unusedRot{};
+            CreateFilters(transType, trans, unusedRot);
+            CreateFilters(rotType, unused, rot);
+            trackerModifier.SetFwdToStage(reference);
+            hmdModifier.SetFwdToStage(reference);
+        }
+
+        TransFilter trans{};
+        RotFilter rot{};
+        modifier::TrackerModifier trackerModifier;
+        modifier::HmdModifier hmdModifier;
+        XrPosef reference{TrackerPose(0)};
+        XrPosef eyeToHmd{{0.f, 0.f, 0.f, 1.f}, {0.032f, 0.f, 0.f}};
+        XrPosef refToStage{{0.f, 0.f, 0.f, 1.f}, {0.f, -1.2f, 0.f}};
+        XrPosef stageToRef{Pose::Invert(refToStage)};
+        std::array<XrPosef, 2> views{XrPosef{{0.f, 0.f, 0.f, 1.f}, {-0.032f, 1.2f, 0.f}},
+                                     XrPosef{{0.f, 0.f, 0.f, 1.f}, {0.032f, 1.2f, 0.f}}};
+    };
+} // namespace
+
+// all replaceable allocation functions allocate with malloc (or aligned_alloc) and release with free
+namespace
+{
+    void* Allocate(const size_t size, const size_t alignment) noexcept
+    {
+        g_Allocations.fetch_add(1, std::memory_order_relaxed);
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return std::malloc(size ? size : 1);
+        }
+        // size has to be a multiple of the alignment
+        return std::aligned_alloc(alignment, (std::max(size, size_t{1}) + alignment - 1) / alignment * alignment);
+    }
+
+    void* AllocateOrThrow(const size_t size, const size_t alignment)
+    {
+        if (void* memory = Allocate(size, alignment))
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+} // namespace
+
+void* operator new(const size_t size)
+{
+    return AllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](const size_t size)
+{
+    return AllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment)
+{
+    return AllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment)
+{
+    return AllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(const size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return Allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return Allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+// ControllerBase::GetPoseDelta -> TrackerBase::ApplyFilters
+static void BM_Filters(benchmark::State& state)
+{
+    Pipeline pipeline(state.range(0), state.range(1));
+    Run(state, [&pipeline](const int64_t frame) {
+        XrPosef pose = TrackerPose(frame);
+        ApplyFilters(pipeline.trans, pipeline.rot, pose, frame * frameInterval);
+        benchmark::DoNotOptimize(pose);
+    });
+}
+BENCHMARK(BM_Filters)->ArgsProduct({{1, 2, 3, 4, 5}, {1, 2, 3, 4, 5}})->ArgNames({"trans", "rot"});
+
+// TrackerBase::ApplyModifier
+static void BM_TrackerModifier(benchmark::State& state)
+{
+    Pipeline pipeline(1, 1);
+    Run(state, [&pipeline](const int64_t frame) {
+        XrPosef pose = TrackerPose(frame);
+        pipeline.trackerModifier.Apply(pose, pipeline.reference);
+        benchmark::DoNotOptimize(pose);
+    });
+}
+BENCHMARK(BM_TrackerModifier);
+
+// delta between current and reference pose
+static void BM_Delta(benchmark::State& state)
+{
+    Pipeline pipeline(1, 1);
+    Run(state, [&pipeline](const int64_t frame) {
+        XrPosef delta = Pose::Multiply(Pose::Invert(TrackerPose(frame)), pipeline.reference);
+        benchmark::DoNotOptimize(delta);
+    });
+}
+BENCHMARK(BM_Delta);
+
+// hmd modifier applied on the delta in OpenXrLayer::xrLocateViews
+static void BM_HmdModifier(benchmark::State& state)
+{
+    Pipeline pipeline(1, 1);
+    Run(state, [&pipeline](const int64_t frame) {
+        XrPosef delta = Pose::Multiply(Pose::Invert(TrackerPose(frame)), pipeline.reference);
+        const XrPosef hmdPoseStage =
+            Pose::Multiply(Pose::Multiply(pipeline.eyeToHmd, pipeline.views[0]), pipeline.stageToRef);
+        pipeline.hmdModifier.Apply(delta, hmdPoseStage);
+        benchmark::DoNotOptimize(delta);
+    });
+}
+BENCHMARK(BM_HmdModifier);
+
+// compensation of view poses in OpenXrLayer::xrLocateViews
+static void BM_ViewPoses(benchmark::State& state)
+{
+    Pipeline pipeline(1, 1);
+    Run(state, [&pipeline](const int64_t frame) {
+        XrPosef delta = Pose::Multiply(Pose::Invert(TrackerPose(frame)), pipeline.reference);
+        delta = Pose::Multiply(Pose::Multiply(pipeline.stageToRef, delta), pipeline.refToStage);
+        for (XrPosef& view : pipeline.views)
+        {
+            benchmark::DoNotOptimize(xr::Normalize(Pose::Multiply(view, delta)));
+        }
+    });
+}
+BENCHMARK(BM_ViewPoses);
+
+// all stages of a frame
+static void BM_Frame(benchmark::State& state)
+{
+    Pipeline pipeline(state.range(0), state.range(1));
+    Run(state, [&pipeline](const int64_t frame) {
+        XrPosef pose = TrackerPose(frame);
+        ApplyFilters(pipeline.trans, pipeline.rot, pose, frame * frameInterval);
+        pipeline.trackerModifier.Apply(pose, pipeline.reference);
+        XrPosef delta = Pose::Multiply(Pose::Invert(pose), pipeline.reference);
+        const XrPosef hmdPoseStage =
+            Pose::Multiply(Pose::Multiply(pipeline.eyeToHmd, pipeline.views[0]), pipeline.stageToRef);
+        pipeline.hmdModifier.Apply(delta, hmdPoseStage);
+        delta = Pose::Multiply(Pose::Multiply(pipeline.stageToRef, delta), pipeline.refToStage);
+        for (XrPosef& view : pipeline.views)
+        {
+            benchmark::DoNotOptimize(xr::Normalize(Pose::Multiply(view, delta)));
+        }
+    });
+}
+BENCHMARK(BM_Frame)->ArgsProduct({{1, 2, 3}, {1, 2, 3}})->ArgNames({"trans", "rot"});
+
+// vectorized ema stages compared to a scalar implementation
+template <size_t Order>
+static void BM_Ema(benchmark::State& state)
+{
+    EmaFilter<Order> ema(0.5f);
+    ema.Reset({0.f, 0.f, 0.f});
+    Run(state, [&ema](const int64_t frame) {
+        XrVector3f location = TrackerPose(frame).position;
+        ema.Filter(location, frame * frameInterval);
+        benchmark::DoNotOptimize(location);
+    });
+}
+BENCHMARK(BM_Ema<1>);
+BENCHMARK(BM_Ema<2>);
+BENCHMARK(BM_Ema<3>);
+
+template <size_t Order>
+static void BM_EmaScalar(benchmark::State& state)
+{
+    reference::ScalarEma<Order> ema(0.5f, 1.f);
+    ema.Reset({0.f, 0.f, 0.f});
+    Run(state, [&ema](const int64_t frame) {
+        XrVector3f location = TrackerPose(frame).position;
+        ema.Filter(location);
+        benchmark::DoNotOptimize(location);
+    });
+}
+BENCHMARK(BM_EmaScalar<1>);
+BENCHMARK(BM_EmaScalar<2>);
+BENCHMARK(BM_EmaScalar<3>);
+
+// slerp stages using normalized lerp for small differences compared to exact slerp
+template <size_t Order>
+static void BM_Slerp(benchmark::State& state)
+{
+    SlerpFilter<Order> slerp(0.5f);
+    slerp.Reset(Quaternion::Identity());
+    Run(state, [&slerp](const int64_t frame) {
+        XrQuaternionf rotation = TrackerPose(frame).orientation;
+        slerp.Filter(rotation, frame * frameInterval);
+        benchmark::DoNotOptimize(rotation);
+    });
+}
+BENCHMARK(BM_Slerp<1>);
+BENCHMARK(BM_Slerp<3>);
+
+template <size_t Order>
+static void BM_SlerpExact(benchmark::State& state)
+{
+    reference::ExactSlerp<Order> slerp(0.5f);
+    slerp.Reset(Quaternion::Identity());
+    Run(state, [&slerp](const int64_t frame) {
+        XrQuaternionf rotation = TrackerPose(frame).orientation;
+        slerp.Filter(rotation);
+        benchmark::DoNotOptimize(rotation);
+    });
+}
+BENCHMARK(BM_SlerpExact<1>);
+BENCHMARK(BM_SlerpExact<3>);
+
+// input stabilizer processing all dofs in one pass compared to one scalar filter per dof
+template <size_t Sections>
+static void BM_BiQuad(benchmark::State& state)
+{
+    BiQuadStabilizer<Sections> biquad({sway, surge, heave, yaw, roll, pitch});
+    biquad.SetStrength(0.5f);
+    biquad.SetStartTime(1000000);
+    Run(state, [&biquad](const int64_t frame) {
+        const XrPosef pose = TrackerPose(frame);
+        Dof dof{{pose.position.x, pose.position.y, pose.position.z, pose.orientation.x, pose.orientation.y,
+                 pose.orientation.z}};
+        biquad.Insert(dof, (frame + 1) * 1000000);
+        biquad.Read(dof);
+        benchmark::DoNotOptimize(dof);
+    });
+}
+BENCHMARK(BM_BiQuad<1>);
+BENCHMARK(BM_BiQuad<2>);
+
+template <size_t Sections>
+static void BM_BiQuadScalar(benchmark::State& state)
+{
+    std::vector<reference::ScalarBiQuad> biquads(6, reference::ScalarBiQuad(Sections, 1000.0, 5.0, 0.0, 2.0));
+    Run(state, [&biquads](const int64_t frame) {
+        const XrPosef pose = TrackerPose(frame);
+        Dof dof{{pose.position.x, pose.position.y, pose.position.z, pose.orientation.x, pose.orientation.y,
+                 pose.orientation.z}};
+        for (size_t i = 0; i < 6; i++)
+        {
+            dof.data[i] = static_cast<float>(biquads[i].Filter(dof.data[i]));
+        }
+        benchmark::DoNotOptimize(dof);
+    });
+}
+BENCHMARK(BM_BiQuadScalar<1>);
+BENCHMARK(BM_BiQuadScalar<2>);
+
+int main(int argc, char** argv)
+{
+    // default configuration with active pose modifiers, to include their calculations
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "oxrmc_benchmark";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::copy_file(OXRMC_DEFAULT_CONFIG, directory / "OpenXR-MotionCompensation.ini");
+    const std::string appConfig = (directory / "benchmark.ini").string();
+    WritePrivateProfileString("pose_modifier", "enabled", "1", appConfig.c_str());
+    WritePrivateProfileString("pose_modifier", "tracker_roll", "0.8", appConfig.c_str());
+    WritePrivateProfileString("pose_modifier", "tracker_sway", "0.8", appConfig.c_str());
+    WritePrivateProfileString("pose_modifier", "hmd_pitch", "0.8", appConfig.c_str());
+    WritePrivateProfileString("pose_modifier", "hmd_heave", "0.8", appConfig.c_str());
+    openxr_api_layer::localAppData = directory;
+    if (!GetConfig()->Init("benchmark"))
+    {
+        fprintf(stderr, "unable to load configuration from %s\n", directory.string().c_str());
+        return 1;
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    std::filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,146 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+#include "pch.h"
+
+// straightforward scalar implementations of the filters, used to verify and benchmark the optimized ones
+namespace reference
+{
+    // cascaded ema stages, calculated one component at a time
+    template <size_t Order>
+    class ScalarEma
+    {
+      public:
+        ScalarEma(const float strength, const float verticalFactor)
+            : m_Strength{strength, std::min(1.f, verticalFactor * strength), strength}
+        {}
+
+        void Reset(const XrVector3f& location)
+        {
+            for (auto& stage : m_Stages)
+            {
+                stage = {location.x, location.y, location.z};
+            }
+        }
+
+        void Filter(XrVector3f& location)
+        {
+            float* components[3]{&location.x, &location.y, &location.z};
+            for (size_t c = 0; c < 3; c++)
+            {
+                float current = *components[c];
+                for (size_t i = 0; i < Order; i++)
+                {
+                    current = (1.f - m_Strength[c]) * current + m_Strength[c] * m_Stages[i][c];
+                    m_Stages[i][c] = current;
+                }
+                if constexpr (1 == Order)
+                {
+                    *components[c] = m_Stages[0][c];
+                }
+                else if constexpr (2 == Order)
+                {
+                    *components[c] = 2.f * m_Stages[0][c] - m_Stages[1][c];
+                }
+                else
+                {
+                    *components[c] = 3.f * (m_Stages[0][c] - m_Stages[1][c]) + m_Stages[2][c];
+                }
+            }
+        }
+
+      private:
+        std::array<float, 3> m_Strength;
+        std::array<std::array<float, 3>, Order> m_Stages{};
+    };
+
+    // cascaded slerp stages, always using the exact spherical interpolation
+    template <size_t Order>
+    class ExactSlerp
+    {
+      public:
+        explicit ExactSlerp(const float strength) : m_Strength(strength)
+        {
+            m_Stages.fill(xr::math::Quaternion::Identity());
+        }
+
+        void Reset(const XrQuaternionf& rotation)
+        {
+            m_Stages.fill(rotation);
+        }
+
+        void Filter(XrQuaternionf& rotation)
+        {
+            for (XrQuaternionf& stage : m_Stages)
+            {
+                stage = xr::math::Quaternion::Slerp(rotation, stage, m_Strength);
+                rotation = stage;
+            }
+        }
+
+      private:
+        float m_Strength;
+        std::array<XrQuaternionf, Order> m_Stages{};
+    };
+
+    // optional notch followed by a butterworth low pass of order 2 * sections for a single dof
+    class ScalarBiQuad
+    {
+      public:
+        ScalarBiQuad(const size_t sections,
+                     const double samplingFrequency,
+                     const double cutoff,
+                     const double notch,
+                     const double bandwidth)
+        {
+            if (notch > 0.0)
+            {
+                const double omega = 2.0 * M_PI * notch / samplingFrequency;
+                const double alpha = sin(omega) * bandwidth / (2.0 * notch);
+                const double norm = 1.0 / (1.0 + alpha);
+                m_Sections.push_back(
+                    {norm, -2.0 * cos(omega) * norm, norm, -2.0 * cos(omega) * norm, (1.0 - alpha) * norm});
+            }
+            const double a = tan(M_PI * cutoff / samplingFrequency);
+            for (size_t k = 0; k < sections; k++)
+            {
+                const double q = 1.0 / (2.0 * sin((2.0 * k + 1.0) * M_PI / (4.0 * sections)));
+                const double norm = 1.0 / (a * a + a / q + 1.0);
+                m_Sections.push_back({a * a * norm,
+                                      2.0 * a * a * norm,
+                                      a * a * norm,
+                                      2.0 * (a * a - 1.0) * norm,
+                                      (a * a - a / q + 1.0) * norm});
+            }
+        }
+
+        double Filter(double input)
+        {
+            for (Section& s : m_Sections)
+            {
+                if (!m_Initialized)
+                {
+                    // steady state for the first input
+                    const double output = (s.b0 + s.b1 + s.b2) / (1.0 + s.a1 + s.a2) * input;
+                    s.z1 = output - s.b0 * input;
+                    s.z2 = s.b2 * input - s.a2 * output;
+                }
+                const double output = s.b0 * input + s.z1;
+                s.z1 = s.b1 * input - s.a1 * output + s.z2;
+                s.z2 = s.b2 * input - s.a2 * output;
+                input = output;
+            }
+            m_Initialized = true;
+            return input;
+        }
+
+      private:
+        struct Section
+        {
+            double b0, b1, b2, a1, a2, z1{0.0}, z2{0.0};
+        };
+        std::vector<Section> m_Sections;
+        bool m_Initialized{false};
+    };
+} // namespace reference
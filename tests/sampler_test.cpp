@@ -0,0 +1,443 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "test_config.h"
+#include "sampler.h"
+#include <condition_variable>
+
+using namespace sampler;
+using namespace utility;
+
+namespace
+{
+    // xr time is steady clock time within the tests, as the performance counter on windows
+    XrResult ConvertTime(XrInstance, const XrTime time, LARGE_INTEGER* counter)
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        counter->QuadPart = time / 1000000 * frequency.QuadPart / 1000 +
+                            time % 1000000 * frequency.QuadPart / 1000000000;
+        return XR_SUCCESS;
+    }
+
+    XrResult GetInstanceProcAddr(XrInstance, const char* name, PFN_xrVoidFunction* function)
+    {
+        if (std::string("xrConvertTimeToWin32PerformanceCounterKHR") != name)
+        {
+            return XR_ERROR_FUNCTION_UNSUPPORTED;
+        }
+        *function = reinterpret_cast<PFN_xrVoidFunction>(&ConvertTime);
+        return XR_SUCCESS;
+    }
+
+    // constant values, counting the sampling cycles
+    // with a step set, values rise by it on every read (or every step period, if set), the times and values read are
+    // kept for comparison
+    // with a hold count set, the sampler thread is parked at the read following the given number of samples until
+    // released, so its state doesn't depend on scheduling
+    class ConstantSource : public SampleSource, public DataSource
+    {
+      public:
+        DataSource* GetSource() override
+        {
+            return this;
+        }
+
+        bool ReadSource(XrTime time, Dof& dof) override
+        {
+            if (++m_Reads > m_Hold)
+            {
+                std::unique_lock lock(m_Mutex);
+                m_Held = true;
+                m_Condition.notify_all();
+                m_Condition.wait(lock, [this] { return m_Released; });
+            }
+            dof = m_Value;
+            const int64_t steps = m_StepPeriod > 0 && !m_Times.empty() ? (time - m_Times.front()) / m_StepPeriod
+                                                                       : static_cast<int64_t>(m_Times.size());
+            for (const float step = static_cast<float>(steps); float& value : dof.data)
+            {
+                value += step * m_Step;
+            }
+            m_Times.push_back(time);
+            m_Values.push_back(dof);
+            return true;
+        }
+
+        bool Open(int64_t time) override
+        {
+            return m_Available;
+        }
+
+        bool Read(void* buffer, size_t size, int64_t time) override
+        {
+            return false;
+        }
+
+        bool WaitForReads(const uint64_t count) const
+        {
+            const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (m_Reads.load() < count && std::chrono::steady_clock::now() < timeout)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return m_Reads.load() >= count;
+        }
+
+        void WaitForHold()
+        {
+            std::unique_lock lock(m_Mutex);
+            m_Condition.wait(lock, [this] { return m_Held; });
+        }
+
+        void Release()
+        {
+            std::unique_lock lock(m_Mutex);
+            m_Released = true;
+            m_Condition.notify_all();
+        }
+
+        Dof m_Value{{10.f, 20.f, 30.f, 40.f, 50.f, 60.f}};
+        float m_Step{0.f};
+        int64_t m_StepPeriod{0};
+        std::vector<XrTime> m_Times;
+        std::vector<Dof> m_Values;
+        bool m_Available{true};
+        std::atomic<uint64_t> m_Reads{0};
+        uint64_t m_Hold{std::numeric_limits<uint64_t>::max()};
+
+      private:
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_Held{false}, m_Released{false};
+    };
+
+    // keeps the samples fed into the stabilizer, along with the time of the source read they originate from
+    class InsertRecorder : public output::RecorderBase
+    {
+      public:
+        explicit InsertRecorder(const ConstantSource& source) : m_Source(source) {}
+
+        void SetFwdToStage(const XrPosef& pose) override {}
+        bool Toggle(bool isCalibrated) override
+        {
+            return false;
+        }
+        void AddFrameTime(XrTime time) override {}
+        void AddPose(const XrPosef& pose, output::RecorderPoseInput type) override {}
+
+        void AddDofValues(const Dof& dofValues, const output::RecorderDofInput type) override
+        {
+            if (output::Sampled == type)
+            {
+                m_Sampled = dofValues;
+            }
+        }
+
+        void Write(const bool sampled, bool newLine) override
+        {
+            if (sampled)
+            {
+                m_Times.push_back(m_Source.m_Times.back());
+                m_Values.push_back(m_Sampled);
+            }
+        }
+
+        std::vector<XrTime> m_Times;
+        std::vector<Dof> m_Values;
+
+      private:
+        const ConstantSource& m_Source;
+        Dof m_Sampled{};
+    };
+} // namespace
+
+TEST(IntervalHistogramTest, MeanAndMax)
+{
+    IntervalHistogram histogram;
+    histogram.SetResolution(100);
+    histogram.Add(1000);
+    histogram.Add(2000);
+    histogram.Add(3000);
+    EXPECT_EQ(3u, histogram.GetCount());
+    EXPECT_EQ(2000, histogram.GetMean());
+    EXPECT_EQ(3000, histogram.GetMax());
+}
+
+TEST(IntervalHistogramTest, PercentileIsUpperBucketLimit)
+{
+    IntervalHistogram histogram;
+    histogram.SetResolution(100);
+    for (int i = 0; i < 99; i++)
+    {
+        histogram.Add(1050);
+    }
+    histogram.Add(5020);
+    EXPECT_EQ(1100, histogram.GetPercentile(0.5));
+    EXPECT_EQ(1100, histogram.GetPercentile(0.99));
+    // limited to the maximum interval
+    EXPECT_EQ(5020, histogram.GetPercentile(1.0));
+}
+
+TEST(IntervalHistogramTest, LongIntervalsShareLastBucket)
+{
+    IntervalHistogram histogram;
+    histogram.SetResolution(10);
+    histogram.Add(10);
+    histogram.Add(1000000);
+    EXPECT_EQ(1000000, histogram.GetMax());
+    EXPECT_EQ(1000000, histogram.GetPercentile(1.0));
+}
+
+TEST(IntervalHistogramTest, ClearResetsStatistics)
+{
+    IntervalHistogram histogram;
+    histogram.Add(1000);
+    histogram.Clear();
+    EXPECT_EQ(0u, histogram.GetCount());
+    EXPECT_EQ(0, histogram.GetMean());
+    EXPECT_EQ(0, histogram.GetMax());
+}
+
+class SamplerTest : public ConfigTest
+{
+  protected:
+    void SetUp() override
+    {
+        ConfigTest::SetUp();
+        Configure();
+        ASSERT_TRUE(Load());
+    }
+
+    // configuration overrides of the test
+    virtual void Configure() {}
+
+    ConstantSource m_Source;
+    const std::vector<DofValue> m_Relevant{sway, surge, heave, yaw, roll, pitch};
+};
+
+TEST_F(SamplerTest, StabilizesConstantInput)
+{
+    Sampler sampler(&m_Source, m_Relevant, nullptr);
+    sampler.SetStrength(0.5f);
+    m_Source.m_Hold = 20;
+    sampler.StartSampling();
+    m_Source.WaitForHold();
+
+    Dof dof{};
+    EXPECT_TRUE(sampler.ReadData(dof, 0));
+    m_Source.Release();
+    sampler.StopSampling();
+    for (const DofValue value : m_Relevant)
+    {
+        EXPECT_NEAR(m_Source.m_Value.data[value], dof.data[value], 1e-3f) << "dof " << value;
+    }
+}
+
+TEST_F(SamplerTest, ReadDataRestartsSampling)
+{
+    Sampler sampler(&m_Source, m_Relevant, nullptr);
+    m_Source.m_Available = false;
+    Dof dof{};
+    EXPECT_FALSE(sampler.ReadData(dof, 0));
+    EXPECT_EQ(0u, m_Source.m_Reads.load());
+
+    m_Source.m_Available = true;
+    EXPECT_TRUE(sampler.ReadData(dof, 0));
+    EXPECT_TRUE(m_Source.WaitForReads(5));
+    sampler.StopSampling();
+}
+
+// reads aligned to the display time, the filter is disabled to keep the sampled values
+class SamplerAlignmentTest : public SamplerTest
+{
+  protected:
+    static constexpr uint64_t samples{10};
+
+    void Configure() override
+    {
+        Override("input_stabilizer", "extrapolation_limit", "2.0");
+    }
+
+    void SetUp() override
+    {
+        SamplerTest::SetUp();
+        GetTimeConverter()->Init(XR_NULL_HANDLE, &GetInstanceProcAddr);
+        m_Source.m_Step = 1.f;
+        m_Source.m_Hold = samples;
+    }
+
+    void TearDown() override
+    {
+        GetTimeConverter()->Init(XR_NULL_HANDLE, nullptr);
+        SamplerTest::TearDown();
+    }
+
+    void ExpectValues(const Dof& expected, const Dof& actual) const
+    {
+        for (const DofValue value : m_Relevant)
+        {
+            EXPECT_NEAR(expected.data[value], actual.data[value], 1e-3f) << "dof " << value;
+        }
+    }
+};
+
+TEST_F(SamplerAlignmentTest, InterpolatesBetweenSamples)
+{
+    Sampler sampler(&m_Source, m_Relevant, nullptr);
+    sampler.SetStrength(0.f);
+    sampler.StartSampling();
+    m_Source.WaitForHold();
+    ASSERT_EQ(samples, m_Source.m_Times.size());
+
+    const XrTime lowerTime = m_Source.m_Times[3], upperTime = m_Source.m_Times[4];
+    const XrTime time = lowerTime + (upperTime - lowerTime) / 4;
+    const float alpha = static_cast<float>(time - lowerTime) / static_cast<float>(upperTime - lowerTime);
+    Dof expected = m_Source.m_Values[3];
+    for (float& value : expected.data)
+    {
+        value += alpha;
+    }
+    Dof dof{};
+    EXPECT_TRUE(sampler.ReadData(dof, time));
+    ExpectValues(expected, dof);
+
+    // exact hit
+    EXPECT_TRUE(sampler.ReadData(dof, upperTime));
+    ExpectValues(m_Source.m_Values[4], dof);
+
+    m_Source.Release();
+    sampler.StopSampling();
+}
+
+TEST_F(SamplerAlignmentTest, ClampsToOldestSample)
+{
+    Sampler sampler(&m_Source, m_Relevant, nullptr);
+    sampler.SetStrength(0.f);
+    sampler.StartSampling();
+    m_Source.WaitForHold();
+    ASSERT_EQ(samples, m_Source.m_Times.size());
+
+    Dof dof{};
+    EXPECT_TRUE(sampler.ReadData(dof, m_Source.m_Times.front() - 5000000));
+    ExpectValues(m_Source.m_Values.front(), dof);
+
+    m_Source.Release();
+    sampler.StopSampling();
+}
+
+TEST_F(SamplerAlignmentTest, ExtrapolationIsLimited)
+{
+    Sampler sampler(&m_Source, m_Relevant, nullptr);
+    sampler.SetStrength(0.f);
+    sampler.StartSampling();
+    m_Source.WaitForHold();
+    ASSERT_EQ(samples, m_Source.m_Times.size());
+
+    // rate of change over the newest samples, continued for the configured 2 ms at most
+    const size_t newest = samples - 1, base = newest - 8;
+    const XrTime newestTime = m_Source.m_Times[newest];
+    const float rate = static_cast<float>(newest - base) /
+                       static_cast<float>(newestTime - m_Source.m_Times[base]);
+    Dof dof{};
+    for (const XrTime offset : {XrTime{1000000}, XrTime{10000000}})
+    {
+        Dof expected = m_Source.m_Values[newest];
+        for (float& value : expected.data)
+        {
+            value += rate * static_cast<float>(std::min(offset, XrTime{2000000}));
+        }
+        EXPECT_TRUE(sampler.ReadData(dof, newestTime + offset));
+        ExpectValues(expected, dof);
+    }
+
+    m_Source.Release();
+    sampler.StopSampling();
+}
+
+TEST_F(SamplerAlignmentTest, FallsBackToLatestWithoutTimeConversion)
+{
+    GetTimeConverter()->Init(XR_NULL_HANDLE, nullptr);
+    Sampler sampler(&m_Source, m_Relevant, nullptr);
+    sampler.SetStrength(0.f);
+    sampler.StartSampling();
+    m_Source.WaitForHold();
+    ASSERT_EQ(samples, m_Source.m_Times.size());
+
+    Dof dof{};
+    EXPECT_TRUE(sampler.ReadData(dof, m_Source.m_Times.front()));
+    ExpectValues(m_Source.m_Values.back(), dof);
+
+    m_Source.Release();
+    sampler.StopSampling();
+}
+
+// feeding only changed input, the recorder keeps track of the inserted samples
+class ChangeDrivenTest : public SamplerTest
+{
+  protected:
+    void Configure() override
+    {
+        Override("input_stabilizer", "change_driven", "1");
+        Override("debug", "record_stabilizer_samples", "1");
+    }
+
+    // samples for the given time, all data is accessed after the sampling thread has been joined
+    void Sample(const std::chrono::milliseconds duration)
+    {
+        Sampler sampler(&m_Source, m_Relevant, m_Recorder);
+        sampler.StartSampling();
+        std::this_thread::sleep_for(duration);
+        sampler.StopSampling();
+    }
+
+    std::shared_ptr<InsertRecorder> m_Recorder{std::make_shared<InsertRecorder>(m_Source)};
+};
+
+TEST_F(ChangeDrivenTest, UnchangedInputIsHeld)
+{
+    Sample(std::chrono::milliseconds(100));
+
+    // the source period can't be determined without updates, so it stays at the sampling interval of 1 ms and the
+    // unchanged value is fed again after twice that period
+    const std::vector<XrTime>& inserts = m_Recorder->m_Times;
+    ASSERT_GE(inserts.size(), 2u);
+    EXPECT_EQ(m_Source.m_Times.front(), inserts.front());
+    for (size_t i = 1; i < inserts.size(); i++)
+    {
+        EXPECT_GE(inserts[i] - inserts[i - 1], 2000000) << "insert " << i;
+    }
+}
+
+TEST_F(ChangeDrivenTest, UpdatesAreFedOnce)
+{
+    m_Source.m_Step = 1.f;
+    m_Source.m_StepPeriod = 10000000;
+    Sample(std::chrono::milliseconds(600));
+
+    // every insert is either an update, at the first read observing it, or a repetition of the preceding value
+    const std::vector<XrTime>& inserts = m_Recorder->m_Times;
+    const std::vector<Dof>& values = m_Recorder->m_Values;
+    ASSERT_GE(inserts.size(), 30u);
+    for (size_t i = 0, read = 0; i < inserts.size(); i++)
+    {
+        read = std::ranges::find(m_Source.m_Times.begin() + read, m_Source.m_Times.end(), inserts[i]) -
+               m_Source.m_Times.begin();
+        ASSERT_LT(read, m_Source.m_Times.size()) << "insert " << i;
+        EXPECT_FLOAT_EQ(m_Source.m_Values[read].data[sway], values[i].data[sway]) << "insert " << i;
+        if (i > 0 && values[i].data[sway] != values[i - 1].data[sway])
+        {
+            EXPECT_NE(m_Source.m_Values[read - 1].data[sway], values[i].data[sway]) << "insert " << i;
+        }
+    }
+
+    // once the source period (10 ms) is tracked, no value is repeated and polling pauses between updates
+    const auto settled = std::ranges::lower_bound(inserts, inserts.front() + 300000000) - inserts.begin();
+    for (size_t i = settled + 1; i < inserts.size(); i++)
+    {
+        EXPECT_GT(values[i].data[sway], values[i - 1].data[sway]) << "insert " << i;
+    }
+    const auto reads = std::ranges::count_if(m_Source.m_Times, [&](const XrTime time) {
+        return time > inserts[settled] && time <= inserts.back();
+    });
+    EXPECT_LE(reads, 4 * static_cast<int64_t>(inserts.size() - settled - 1));
+}
@@ -0,0 +1,50 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#pragma once
+
+#include "pch.h"
+#include "config.h"
+#include <gtest/gtest.h>
+
+// provides the default configuration file in a temporary directory, values can be overridden per test
+// overrides are written into the application specific configuration file, like the layer does on saving
+class ConfigTest : public ::testing::Test
+{
+  protected:
+    static constexpr const char* application{"test"};
+
+    void SetUp() override
+    {
+        const ::testing::TestInfo* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        std::string name = std::string("oxrmc_") + info->test_suite_name() + "_" + info->name();
+        std::ranges::replace(name, '/', '_');
+        m_Directory = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(m_Directory);
+        std::filesystem::create_directories(m_Directory);
+        std::filesystem::copy_file(OXRMC_DEFAULT_CONFIG, m_Directory / "OpenXR-MotionCompensation.ini");
+        openxr_api_layer::localAppData = m_Directory;
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_Directory);
+    }
+
+    // override a value in the application specific configuration, takes effect with the next call of Load
+    void Override(const std::string& section, const std::string& key, const std::string& value) const
+    {
+        WritePrivateProfileString(section.c_str(), key.c_str(), value.c_str(), AppConfig().string().c_str());
+    }
+
+    [[nodiscard]] std::filesystem::path AppConfig() const
+    {
+        return m_Directory / (std::string(application) + ".ini");
+    }
+
+    static bool Load()
+    {
+        return GetConfig()->Init(application);
+    }
+
+    std::filesystem::path m_Directory;
+};
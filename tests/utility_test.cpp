@@ -0,0 +1,419 @@
+// Copyright(c) 2024 Sebastian Veith
+
+#include "test_config.h"
+#include "utility.h"
+
+using namespace utility;
+
+namespace
+{
+    XrPosef Pose(const float x, const float yaw)
+    {
+        return {{0.f, std::sin(yaw / 2.f), 0.f, std::cos(yaw / 2.f)}, {x, 0.f, 0.f}};
+    }
+
+    float Yaw(const XrPosef& pose)
+    {
+        return 2.f * std::atan2(pose.orientation.y, pose.orientation.w);
+    }
+} // namespace
+
+TEST(RingBufferTest, KeepsTimeOrder)
+{
+    RingBuffer<int> ring(8);
+    bool existing;
+    EXPECT_TRUE(ring.Insert(30, 3, false, existing));
+    EXPECT_TRUE(ring.Insert(10, 1, false, existing));
+    EXPECT_TRUE(ring.Insert(20, 2, false, existing));
+    EXPECT_FALSE(existing);
+
+    Neighborhood<int> result;
+    ring.Bracket(25, 1, result);
+    ASSERT_TRUE(result.lower && result.upper && result.lowerBase);
+    EXPECT_EQ(2, result.lower->second);
+    EXPECT_EQ(3, result.upper->second);
+    EXPECT_EQ(1, result.lowerBase->second);
+}
+
+TEST(RingBufferTest, OverrideExistingEntry)
+{
+    RingBuffer<int> ring(8);
+    bool existing;
+    ring.Insert(10, 1, false, existing);
+    EXPECT_FALSE(ring.Insert(10, 2, false, existing));
+    EXPECT_TRUE(existing);
+
+    Neighborhood<int> result;
+    ring.Bracket(10, 0, result);
+    EXPECT_EQ(1, result.upper->second);
+
+    EXPECT_TRUE(ring.Insert(10, 2, true, existing));
+    EXPECT_TRUE(existing);
+    ring.Bracket(10, 0, result);
+    EXPECT_EQ(2, result.upper->second);
+}
+
+TEST(RingBufferTest, FullBufferDropsOldest)
+{
+    RingBuffer<int> ring(4);
+    bool existing;
+    for (int i = 1; i <= 6; i++)
+    {
+        EXPECT_TRUE(ring.Insert(i * 10, i, false, existing));
+    }
+    // older than every entry of the full buffer
+    EXPECT_FALSE(ring.Insert(5, 0, false, existing));
+
+    Neighborhood<int> result;
+    ring.Bracket(0, 0, result);
+    EXPECT_FALSE(result.lower);
+    ASSERT_TRUE(result.upper);
+    EXPECT_EQ(30, result.upper->first);
+
+    ring.Bracket(100, 0, result);
+    EXPECT_FALSE(result.upper);
+    ASSERT_TRUE(result.lower);
+    EXPECT_EQ(60, result.lower->first);
+}
+
+TEST(RingBufferTest, BracketLimitsBaseDistance)
+{
+    RingBuffer<int> ring(8);
+    bool existing;
+    for (int i = 1; i <= 4; i++)
+    {
+        ring.Insert(i * 10, i, false, existing);
+    }
+    Neighborhood<int> result;
+    ring.Bracket(35, 5, result);
+    ASSERT_TRUE(result.lowerBase);
+    EXPECT_EQ(10, result.lowerBase->first);
+
+    ring.Bracket(15, 1, result);
+    EXPECT_FALSE(result.lowerBase);
+    EXPECT_EQ(0u, ring.GetLockedReads());
+    EXPECT_EQ(0u, ring.GetReadRetries());
+    EXPECT_EQ(0u, ring.GetLockWaits());
+}
+
+TEST(RingBufferTest, EraseBeforeKeepsPrecedingEntry)
+{
+    RingBuffer<int> ring(8);
+    bool existing;
+    for (int i = 1; i <= 5; i++)
+    {
+        ring.Insert(i * 10, i, false, existing);
+    }
+    const std::optional<XrTime> oldest = ring.EraseBefore(35);
+    ASSERT_TRUE(oldest);
+    EXPECT_EQ(30, *oldest);
+
+    Neighborhood<int> result;
+    ring.Bracket(0, 0, result);
+    EXPECT_EQ(30, result.upper->first);
+
+    ring.Clear();
+    ring.Bracket(40, 0, result);
+    EXPECT_FALSE(result.lower);
+    EXPECT_FALSE(result.upper);
+}
+
+TEST(PoseTest, Interpolate)
+{
+    const XrPosef result = Interpolate(Pose(0.f, 0.f), Pose(2.f, 1.f), 0.25f);
+    EXPECT_FLOAT_EQ(0.5f, result.position.x);
+    EXPECT_NEAR(0.25f, Yaw(result), 1e-5f);
+}
+
+TEST(PoseTest, Extrapolate)
+{
+    const XrPosef result = Extrapolate(Pose(1.f, 0.2f), Pose(2.f, 0.4f), 0.5f);
+    EXPECT_FLOAT_EQ(2.5f, result.position.x);
+    EXPECT_NEAR(0.5f, Yaw(result), 1e-5f);
+}
+
+TEST(PoseTest, ExtrapolateTakesShorterPath)
+{
+    // from 3 to -3 rad the shorter path continues in positive direction
+    const XrPosef result = Extrapolate(Pose(0.f, 3.f), Pose(0.f, -3.f), 1.f);
+    const XrPosef expected = Pose(0.f, -3.f + (2.f * floatPi - 6.f));
+    const XrQuaternionf& a = result.orientation;
+    const XrQuaternionf& b = expected.orientation;
+    EXPECT_NEAR(1.f, std::abs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w), 1e-5f);
+}
+
+TEST(PoseTest, UnusedViewsAreCopied)
+{
+    EyePoses from{}, to{};
+    from[0] = Pose(0.f, 0.f);
+    to[0] = Pose(1.f, 0.f);
+    to[2] = Pose(3.f, 0.f);
+
+    const EyePoses interpolated = Interpolate(from, to, 0.5f);
+    EXPECT_FLOAT_EQ(0.5f, interpolated[0].position.x);
+    EXPECT_FLOAT_EQ(3.f, interpolated[2].position.x);
+    EXPECT_FLOAT_EQ(0.f, interpolated[1].orientation.w);
+
+    const EyePoses extrapolated = Extrapolate(from, to, 1.f);
+    EXPECT_FLOAT_EQ(2.f, extrapolated[0].position.x);
+    EXPECT_FLOAT_EQ(3.f, extrapolated[2].position.x);
+}
+
+// cache behavior is identical for map and ring buffer storage
+class CacheTest : public ::testing::TestWithParam<bool>
+{
+  protected:
+    void SetUp() override
+    {
+        m_Cache.SetTolerance(tolerance);
+        m_Cache.UseRingBuffer(GetParam());
+    }
+
+    [[nodiscard]] uint64_t Count(const Cache<XrPosef>::Match match) const
+    {
+        return m_Cache.GetStatistics().matches[match];
+    }
+
+    static constexpr XrTime tolerance{10000000};
+    Cache<XrPosef> m_Cache{"test", Pose(-1.f, 0.f)};
+};
+
+TEST_P(CacheTest, FallbackWhenEmpty)
+{
+    EXPECT_FLOAT_EQ(-1.f, m_Cache.GetSample(100).position.x);
+    EXPECT_EQ(1u, Count(Cache<XrPosef>::Fallback));
+}
+
+TEST_P(CacheTest, ExactAndLaterMatch)
+{
+    m_Cache.AddSample(100000000, Pose(1.f, 0.f), false);
+    m_Cache.AddSample(100000000, Pose(2.f, 0.f), false);
+    EXPECT_FLOAT_EQ(1.f, m_Cache.GetSample(100000000).position.x);
+    m_Cache.AddSample(100000000, Pose(2.f, 0.f), true);
+    EXPECT_FLOAT_EQ(2.f, m_Cache.GetSample(100000000).position.x);
+    EXPECT_EQ(2u, Count(Cache<XrPosef>::Exact));
+
+    EXPECT_FLOAT_EQ(2.f, m_Cache.GetSample(95000000).position.x);
+    EXPECT_EQ(1u, Count(Cache<XrPosef>::Later));
+    EXPECT_FLOAT_EQ(2.f, m_Cache.GetSample(105000000).position.x);
+    EXPECT_EQ(1u, Count(Cache<XrPosef>::Earlier));
+}
+
+TEST_P(CacheTest, InterpolatedMatch)
+{
+    m_Cache.UseInterpolation(true);
+    m_Cache.SetFramePeriod(10000000);
+    m_Cache.AddSample(100000000, Pose(1.f, 0.f), false);
+    m_Cache.AddSample(110000000, Pose(2.f, 0.f), false);
+    EXPECT_FLOAT_EQ(1.25f, m_Cache.GetSample(102500000).position.x);
+    EXPECT_EQ(1u, Count(Cache<XrPosef>::Interpolated));
+}
+
+TEST_P(CacheTest, GapTooLargeUsesNearest)
+{
+    m_Cache.UseInterpolation(true);
+    m_Cache.SetFramePeriod(1000000);
+    m_Cache.AddSample(100000000, Pose(1.f, 0.f), false);
+    m_Cache.AddSample(110000000, Pose(2.f, 0.f), false);
+    EXPECT_FLOAT_EQ(2.f, m_Cache.GetSample(108000000).position.x);
+    EXPECT_EQ(1u, Count(Cache<XrPosef>::Later));
+    EXPECT_EQ(0u, Count(Cache<XrPosef>::Interpolated));
+}
+
+TEST_P(CacheTest, ExtrapolatedMatch)
+{
+    m_Cache.SetExtrapolationLimit(20000000);
+    m_Cache.AddSample(100000000, Pose(1.f, 0.f), false);
+    m_Cache.AddSample(110000000, Pose(2.f, 0.f), false);
+    EXPECT_FLOAT_EQ(2.5f, m_Cache.GetSample(115000000).position.x);
+    // horizon is limited
+    EXPECT_FLOAT_EQ(4.f, m_Cache.GetSample(200000000).position.x);
+    EXPECT_EQ(2u, Count(Cache<XrPosef>::Extrapolated));
+}
+
+TEST_P(CacheTest, CleanUpKeepsPrecedingEntry)
+{
+    for (int i = 1; i <= 5; i++)
+    {
+        m_Cache.AddSample(i * 100000000, Pose(static_cast<float>(i), 0.f), false);
+    }
+    m_Cache.CleanUp(400000000);
+    EXPECT_FLOAT_EQ(3.f, m_Cache.GetSample(305000000).position.x);
+    EXPECT_EQ(0u, Count(Cache<XrPosef>::Estimated));
+    EXPECT_FLOAT_EQ(3.f, m_Cache.GetSample(100000000).position.x);
+    EXPECT_EQ(1u, Count(Cache<XrPosef>::Estimated));
+}
+
+INSTANTIATE_TEST_SUITE_P(Storage, CacheTest, ::testing::Values(false, true), [](const auto& info) {
+    return info.param ? "RingBuffer" : "Map";
+});
+
+TEST(RecordingTest, ParsesUnfilteredAndFilteredValues)
+{
+    const std::filesystem::path file = std::filesystem::temp_directory_path() / "oxrmc_recording_test.csv";
+    {
+        std::ofstream stream(file);
+        stream << "Elapsed (ms); Time; FrameTime; ...\n";
+        stream << "0.0;1000;0;1;2;0;3;4;0;5;6;0;7;8;0;9;10;0;11;12;0\n";
+        // written without time progression
+        stream << "0.0;1000;0;0;0;0;0;0;0;0;0;0;0;0;0;0;0;0;0;0;0\n";
+        stream << "incomplete;line\n";
+        stream << "0.5;1500;0;13;14;0;15;16;0;17;18;0;19;20;0;21;22;0;23;24;0\n";
+    }
+    std::vector<int64_t> times;
+    std::vector<Dof> unfiltered, filtered;
+    ASSERT_TRUE(Recording::Parse(file, times, unfiltered, filtered));
+    std::filesystem::remove(file);
+
+    ASSERT_EQ(2u, times.size());
+    ASSERT_EQ(2u, unfiltered.size());
+    ASSERT_EQ(2u, filtered.size());
+    EXPECT_EQ(0, times[0]);
+    EXPECT_EQ(500, times[1]);
+    for (int i = 0; i < 6; i++)
+    {
+        EXPECT_FLOAT_EQ(1.f + 2.f * i, unfiltered[0].data[i]);
+        EXPECT_FLOAT_EQ(2.f + 2.f * i, filtered[0].data[i]);
+        EXPECT_FLOAT_EQ(13.f + 2.f * i, unfiltered[1].data[i]);
+        EXPECT_FLOAT_EQ(14.f + 2.f * i, filtered[1].data[i]);
+    }
+}
+
+TEST(SyntheticTest, WithoutNoise)
+{
+    // noise signal without noise amplitude, negative values are rejected
+    for (const float noise : {0.f, -1.f})
+    {
+        Synthetic synthetic;
+        synthetic.Configure("noise", 1000.f, noise, 0.f);
+        Dof dof{{1.f, 1.f, 1.f, 1.f, 1.f, 1.f}};
+        ASSERT_TRUE(synthetic.Read(&dof, sizeof(dof), 0));
+        for (const float value : dof.data)
+        {
+            EXPECT_EQ(0.f, value) << "noise " << noise;
+        }
+    }
+}
+
+TEST(SyntheticTest, DropoutsSaturate)
+{
+    // more dropouts than updates per minute start a dropout on every update, freezing the sweep
+    Synthetic synthetic;
+    synthetic.Configure("sweep", 1000.f, 0.f, 1e6f);
+    Dof first{}, second{};
+    ASSERT_TRUE(synthetic.Read(&first, sizeof(first), 0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_TRUE(synthetic.Read(&second, sizeof(second), 0));
+    for (size_t i = 0; i < 6; i++)
+    {
+        EXPECT_EQ(first.data[i], second.data[i]) << "dof " << i;
+    }
+}
+
+// producer and consumer of a memory mapped file, using posix shared memory in the portable build
+class MmfTest : public ConfigTest
+{
+  protected:
+    void SetUp() override
+    {
+        ConfigTest::SetUp();
+        ASSERT_TRUE(Load());
+        m_Name = std::string("Local\\oxrmc_") + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+
+    // layout of FlyPT Mover and SRS
+    struct SixDof
+    {
+        double sway, surge, heave, yaw, roll, pitch;
+    };
+
+    std::string m_Name;
+};
+
+TEST_F(MmfTest, LegacyRoundTrip)
+{
+    MmfWriter writer;
+    ASSERT_TRUE(writer.Create(m_Name, sizeof(SixDof), false));
+    const SixDof written{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    writer.Write(&written, sizeof(written));
+
+    Mmf mmf;
+    mmf.SetName(m_Name);
+    ASSERT_TRUE(mmf.Open(0));
+    SixDof read{};
+    ASSERT_TRUE(mmf.Read(&read, sizeof(read), 0));
+    EXPECT_EQ(0, memcmp(&written, &read, sizeof(read)));
+}
+
+TEST_F(MmfTest, SequencedRoundTrip)
+{
+    MmfWriter writer;
+    ASSERT_TRUE(writer.Create(m_Name, sizeof(SixDof), true));
+    Mmf mmf;
+    mmf.SetName(m_Name);
+    ASSERT_TRUE(mmf.Open(0));
+    for (int i = 1; i <= 3; i++)
+    {
+        const double value = i;
+        const SixDof written{value, -value, 2 * value, -2 * value, 3 * value, -3 * value};
+        writer.Write(&written, sizeof(written));
+        SixDof read{};
+        ASSERT_TRUE(mmf.Read(&read, sizeof(read), 0));
+        EXPECT_EQ(0, memcmp(&written, &read, sizeof(read))) << "write " << i;
+    }
+}
+
+TEST_F(MmfTest, SequencedReadsAreConsistent)
+{
+    MmfWriter writer;
+    ASSERT_TRUE(writer.Create(m_Name, sizeof(SixDof), true));
+    const SixDof initial{};
+    writer.Write(&initial, sizeof(initial));
+    Mmf mmf;
+    mmf.SetName(m_Name);
+    ASSERT_TRUE(mmf.Open(0));
+
+    // all values of a write are equal, a torn read would mix values of consecutive writes
+    constexpr int writes{200000};
+    std::atomic_bool done{false};
+    std::thread producer([&writer, &done] {
+        for (int i = 1; i <= writes; i++)
+        {
+            const double value = i;
+            const SixDof data{value, value, value, value, value, value};
+            writer.Write(&data, sizeof(data));
+        }
+        done = true;
+    });
+    double previous{0.0};
+    uint64_t reads{0};
+    while (!done.load())
+    {
+        SixDof read{};
+        ASSERT_TRUE(mmf.Read(&read, sizeof(read), 0));
+        ASSERT_TRUE(read.surge == read.sway && read.heave == read.sway && read.yaw == read.sway &&
+                    read.roll == read.sway && read.pitch == read.sway)
+            << "read " << reads;
+        ASSERT_GE(read.sway, previous) << "read " << reads;
+        previous = read.sway;
+        reads++;
+    }
+    producer.join();
+    SixDof last{};
+    ASSERT_TRUE(mmf.Read(&last, sizeof(last), 0));
+    EXPECT_EQ(static_cast<double>(writes), last.pitch);
+}
+
+TEST_F(MmfTest, OpenFailsAfterWriterClosed)
+{
+    {
+        MmfWriter writer;
+        ASSERT_TRUE(writer.Create(m_Name, sizeof(SixDof), true));
+        Mmf mmf;
+        mmf.SetName(m_Name);
+        EXPECT_TRUE(mmf.Open(0));
+    }
+    Mmf mmf;
+    mmf.SetName(m_Name);
+    EXPECT_FALSE(mmf.Open(0));
+}
@@ -0,0 +1,197 @@
+// Copyright(c) 2024 Sebastian Veith
+
+// emulation of motion software without a motion rig: writes synthetic motion (sine sweep, steps, noise, dropouts)
+// into the memory mapped file of a virtual tracker, using the struct layout of FlyPT Mover, SRS or Yaw VR
+// in the portable build the mmf is a posix shared memory object, so the virtual tracker path (Mmf::Open / Read
+// and connection refresh) can be load tested and benchmarked on linux, by running oxrmc_soak with --source flypt, srs
+// or yaw alongside
+
+#include "pch.h"
+#include "utility.h"
+#include <csignal>
+
+using namespace utility;
+
+namespace
+{
+    struct Options
+    {
+        std::string tracker{"flypt"};
+        std::string signal{"mixed"};
+        float rate{100.f};
+        float noise{0.01f};
+        float dropouts{0.f};
+        bool sequenced{true};
+        double duration{0.0};
+    };
+
+    // same layouts as SixDofTracker::SixDof and YawTracker::YawData
+    struct SixDof
+    {
+        double sway, surge, heave, yaw, roll, pitch;
+    };
+
+    struct YawData
+    {
+        float yaw, pitch, roll, battery, rotationHeight, rotationForwardHead;
+        bool sixDof, usePos;
+        float autoX, autoY;
+    };
+
+    std::atomic_bool g_Running{true};
+
+    void PrintUsage()
+    {
+        printf("usage: oxrmc_mmf_writer [options]\n"
+               "  --tracker <name>        flypt (default), srs or yaw\n"
+               "  --signal <name>         synthetic signal: sweep, step, noise or mixed (default)\n"
+               "  --rate <Hz>             update rate, default: 100\n"
+               "  --noise <factor>        noise relative to the signal amplitude, default: 0.01\n"
+               "  --dropouts <n>          dropouts (0.25 s freezes) per minute, default: 0\n"
+               "  --sequenced <0|1>       prepend sequence header to avoid torn reads, default: 1\n"
+               "  --duration <s>          stop after the given time, default: 0 (until interrupted)\n");
+    }
+
+    bool ParseOptions(const int argc, char** argv, Options& options)
+    {
+        if (0 == argc % 2)
+        {
+            return false;
+        }
+        try
+        {
+            for (int i = 1; i + 1 < argc; i += 2)
+            {
+                const std::string option(argv[i]), value(argv[i + 1]);
+                if ("--tracker" == option)
+                {
+                    options.tracker = value;
+                }
+                else if ("--signal" == option)
+                {
+                    options.signal = value;
+                }
+                else if ("--rate" == option)
+                {
+                    options.rate = std::max(std::stof(value), 1.f);
+                }
+                else if ("--noise" == option)
+                {
+                    options.noise = std::stof(value);
+                }
+                else if ("--dropouts" == option)
+                {
+                    options.dropouts = std::stof(value);
+                }
+                else if ("--sequenced" == option)
+                {
+                    options.sequenced = 0 != std::stoi(value);
+                }
+                else if ("--duration" == option)
+                {
+                    options.duration = std::stod(value);
+                }
+                else
+                {
+                    fprintf(stderr, "unknown option: %s\n", option.c_str());
+                    return false;
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            fprintf(stderr, "invalid option value: %s\n", e.what());
+            return false;
+        }
+        return true;
+    }
+
+    // mmf names as used by the virtual trackers
+    bool GetName(const std::string& tracker, std::string& name)
+    {
+        if ("flypt" == tracker)
+        {
+            name = "Local\\motionRigPose";
+        }
+        else if ("srs" == tracker)
+        {
+            name = "Local\\SimRacingStudioMotionRigPose";
+        }
+        else if ("yaw" == tracker)
+        {
+            name = "Local\\YawVRGEFile";
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    std::string name;
+    if (!ParseOptions(argc, argv, options) || !GetName(options.tracker, name))
+    {
+        PrintUsage();
+        return 1;
+    }
+    const bool yawLayout = "yaw" == options.tracker;
+    const size_t size = yawLayout ? sizeof(YawData) : sizeof(SixDof);
+
+    MmfWriter writer;
+    if (!writer.Create(name, size, options.sequenced))
+    {
+        fprintf(stderr, "unable to create mmf %s\n", name.c_str());
+        return 1;
+    }
+    Synthetic synthetic;
+    synthetic.Configure(options.signal, options.rate, options.noise, options.dropouts);
+    std::signal(SIGINT, [](int) { g_Running = false; });
+
+    printf("writing %s data to %s at %.0f Hz (%s layout)\n",
+           options.tracker.c_str(),
+           name.c_str(),
+           options.rate,
+           options.sequenced ? "sequenced" : "legacy");
+    fflush(stdout);
+
+    // schedule on absolute time to keep the average rate
+    const std::chrono::nanoseconds period(static_cast<int64_t>(1e9 / options.rate));
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + std::chrono::nanoseconds(static_cast<int64_t>(options.duration * 1e9));
+    uint64_t writes{0};
+    for (auto next = start; g_Running.load() && (options.duration <= 0.0 || next < end); next += period)
+    {
+        Dof dof{};
+        synthetic.Read(&dof, sizeof(dof), 0);
+        if (yawLayout)
+        {
+            YawData data{};
+            data.yaw = dof.data[yaw];
+            data.pitch = dof.data[pitch];
+            data.roll = dof.data[roll];
+            writer.Write(&data, sizeof(data));
+        }
+        else
+        {
+            const SixDof data{dof.data[sway],
+                              dof.data[surge],
+                              dof.data[heave],
+                              dof.data[yaw],
+                              dof.data[roll],
+                              dof.data[pitch]};
+            writer.Write(&data, sizeof(data));
+        }
+        writes++;
+        std::this_thread::sleep_until(next + period);
+    }
+    writer.Close();
+
+    printf("%llu writes in %.1f s\n",
+           static_cast<unsigned long long>(writes),
+           std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    return 0;
+}
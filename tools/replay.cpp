@@ -0,0 +1,398 @@
+// Copyright(c) 2024 Sebastian Veith
+
+// offline evaluation of filter settings on a recording (recording_*.csv written by the pose recorder)
+// the unfiltered values of the recording are fed through input stabilizer and translational / rotational filters
+// with every requested configuration and lag, jitter and processing time are printed for each of them
+
+#include "pch.h"
+#include "config.h"
+#include "filter.h"
+#include "output.h"
+#include <util.h>
+
+using namespace filter;
+using namespace output;
+using namespace utility;
+using namespace xr::math;
+
+namespace
+{
+    struct Options
+    {
+        std::filesystem::path recording;
+        std::filesystem::path config;
+        std::vector<std::string> filters{"ema1", "ema2", "ema3", "one_euro", "kalman"};
+        std::vector<float> strengths{0.25f, 0.5f, 0.75f};
+        std::vector<int> stabilizers{0};
+        std::vector<float> stabilizerStrengths{0.5f};
+        int passes{10};
+    };
+
+    struct Result
+    {
+        Evaluation evaluation;
+        double time{};
+    };
+
+    constexpr const char* dofNames[]{"sway", "surge", "heave", "yaw", "roll", "pitch"};
+
+    void PrintUsage()
+    {
+        printf("usage: oxrmc_replay <recording.csv> [options]\n"
+               "  --config <dir>                 directory of OpenXR-MotionCompensation.ini, default: directory of "
+               "the recording\n"
+               "  --filter <list>                ema1, ema2, ema3 (ema / slerp stages), one_euro, kalman, none\n"
+               "                                 default: ema1,ema2,ema3,one_euro,kalman\n"
+               "  --strength <list>              filter strengths, default: 0.25,0.5,0.75\n"
+               "  --stabilizer <list>            input stabilizer order 0 (off), 2 or 4, default: 0\n"
+               "  --stabilizer_strength <list>   input stabilizer strengths, default: 0.5\n"
+               "  --passes <n>                   replays per configuration for timing, default: 10\n");
+    }
+
+    std::vector<std::string> Split(const std::string& list)
+    {
+        std::vector<std::string> items;
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ','))
+        {
+            items.push_back(item);
+        }
+        return items;
+    }
+
+    template <typename Value>
+    std::vector<Value> SplitNumbers(const std::string& list)
+    {
+        std::vector<Value> values;
+        for (const std::string& item : Split(list))
+        {
+            values.push_back(static_cast<Value>(std::stod(item)));
+        }
+        return values;
+    }
+
+    bool ParseOptions(const int argc, char** argv, Options& options)
+    {
+        if (argc < 2 || std::string(argv[1]).starts_with("--"))
+        {
+            return false;
+        }
+        options.recording = argv[1];
+        options.config = options.recording.parent_path();
+        try
+        {
+            for (int i = 2; i + 1 < argc; i += 2)
+            {
+                const std::string option(argv[i]), value(argv[i + 1]);
+                if ("--config" == option)
+                {
+                    options.config = value;
+                }
+                else if ("--filter" == option)
+                {
+                    options.filters = Split(value);
+                }
+                else if ("--strength" == option)
+                {
+                    options.strengths = SplitNumbers<float>(value);
+                }
+                else if ("--stabilizer" == option)
+                {
+                    options.stabilizers = SplitNumbers<int>(value);
+                }
+                else if ("--stabilizer_strength" == option)
+                {
+                    options.stabilizerStrengths = SplitNumbers<float>(value);
+                }
+                else if ("--passes" == option)
+                {
+                    options.passes = std::max(std::stoi(value), 1);
+                }
+                else
+                {
+                    fprintf(stderr, "unknown option: %s\n", option.c_str());
+                    return false;
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            fprintf(stderr, "invalid option value: %s\n", e.what());
+            return false;
+        }
+        return 0 == argc % 2;
+    }
+
+    // same conversion as FlyPtTracker::DataToPose and PoseRecorder::Write, without constant pitch angle
+    XrPosef DofToPose(const Dof& dof)
+    {
+        XrPosef pose{Pose::Identity()};
+        StoreXrQuaternion(&pose.orientation,
+                          DirectX::XMQuaternionRotationRollPitchYaw(-dof.data[pitch] * angleToRadian,
+                                                                    dof.data[yaw] * angleToRadian,
+                                                                    dof.data[roll] * angleToRadian));
+        pose.position = XrVector3f{dof.data[sway] / 1000.f, dof.data[heave] / 1000.f, dof.data[surge] / 1000.f};
+        return pose;
+    }
+
+    Dof PoseToDof(const XrPosef& pose)
+    {
+        const XrVector3f angles = ToEulerAngles(pose.orientation);
+        return {{pose.position.x * 1000.f,
+                 pose.position.z * 1000.f,
+                 pose.position.y * 1000.f,
+                 angles.y / angleToRadian,
+                 angles.z / angleToRadian,
+                 angles.x / -angleToRadian}};
+    }
+
+    // linear interpolation of recorded values, angles along the shorter arc
+    Dof Interpolate(const std::vector<int64_t>& times, const std::vector<Dof>& values, const int64_t time)
+    {
+        const size_t next = std::upper_bound(times.begin(), times.end(), time) - times.begin();
+        if (0 == next)
+        {
+            return values.front();
+        }
+        if (next >= times.size())
+        {
+            return values.back();
+        }
+        const Dof& from = values[next - 1];
+        const Dof& to = values[next];
+        const float alpha =
+            static_cast<float>(time - times[next - 1]) / static_cast<float>(times[next] - times[next - 1]);
+        Dof dof{};
+        for (int i = 0; i < 6; i++)
+        {
+            float delta = to.data[i] - from.data[i];
+            if (i >= yaw)
+            {
+                delta = fmod(delta + 540.0f, 360.0f) - 180.0f;
+            }
+            dof.data[i] = from.data[i] + alpha * delta;
+        }
+        return dof;
+    }
+
+    bool CreateFilters(const std::string& type, const float strength, TransFilter& trans, RotFilter& rot)
+    {
+        if ("none" == type)
+        {
+            trans.emplace<NoFilter<XrVector3f>>();
+            rot.emplace<NoFilter<XrQuaternionf>>();
+        }
+        else if ("one_euro" == type)
+        {
+            trans.emplace<OneEuroFilter<XrVector3f>>(strength);
+            rot.emplace<OneEuroFilter<XrQuaternionf>>(strength);
+        }
+        else if ("kalman" == type)
+        {
+            trans.emplace<KalmanFilter<XrVector3f>>(strength);
+            rot.emplace<KalmanFilter<XrQuaternionf>>(strength);
+        }
+        else if ("ema1" == type || "ema2" == type || "ema3" == type)
+        {
+            const int order = type.back() - '0';
+            bool timeBasedTrans{false}, timeBasedRot{false};
+            GetConfig()->GetBool(Cfg::TransTimeBased, timeBasedTrans);
+            GetConfig()->GetBool(Cfg::RotTimeBased, timeBasedRot);
+            SetOrder<EmaFilter>(trans, order, strength);
+            SetOrder<SlerpFilter>(rot, order, strength);
+            std::visit([timeBasedTrans](auto& filter) { filter.SetTimeBased(timeBasedTrans); }, trans);
+            std::visit([timeBasedRot](auto& filter) { filter.SetTimeBased(timeBasedRot); }, rot);
+        }
+        else
+        {
+            fprintf(stderr, "invalid filter type: %s\n", type.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::unique_ptr<StabilizerBase> CreateStabilizer(const int order, const float strength)
+    {
+        const std::vector<DofValue> relevant{sway, surge, heave, yaw, roll, pitch};
+        std::unique_ptr<StabilizerBase> stabilizer;
+        if (2 == order)
+        {
+            stabilizer = std::make_unique<BiQuadStabilizer<1>>(relevant);
+        }
+        else if (4 == order)
+        {
+            stabilizer = std::make_unique<BiQuadStabilizer<2>>(relevant);
+        }
+        if (stabilizer)
+        {
+            stabilizer->SetStrength(strength);
+        }
+        return stabilizer;
+    }
+
+    // one pass over the recording, as executed by sampler (stabilizer) and tracker (filters) in the layer
+    // filters are applied on the recorded poses relative to the reference, which is equivalent for the ema / slerp
+    // stages but not exactly for filters scaling individual axes (vertical factor, one euro, kalman)
+    bool Replay(const std::vector<int64_t>& times,
+                const std::vector<Dof>& values,
+                const std::string& type,
+                const float strength,
+                const int stabilizerOrder,
+                const float stabilizerStrength,
+                std::vector<EvaluationSample>& samples)
+    {
+        TransFilter trans{};
+        RotFilter rot{};
+        if (!CreateFilters(type, strength, trans, rot))
+        {
+            return false;
+        }
+        std::unique_ptr<StabilizerBase> stabilizer = CreateStabilizer(stabilizerOrder, stabilizerStrength);
+        if (stabilizerOrder && !stabilizer)
+        {
+            fprintf(stderr, "invalid stabilizer order: %d\n", stabilizerOrder);
+            return false;
+        }
+        float intervalMs{1.f};
+        GetConfig()->GetFloat(Cfg::StabilizerInterval, intervalMs);
+        const int64_t interval = std::max(static_cast<int64_t>(intervalMs * 1000000.f), int64_t{1000});
+        int64_t sampleTime{interval};
+        if (stabilizer)
+        {
+            stabilizer->SetStartTime(0);
+        }
+
+        Dof stabilized = values.front();
+        const XrPosef first = DofToPose(values.front());
+        std::visit([&first](auto& filter) { filter.Reset(first.position); }, trans);
+        std::visit([&first](auto& filter) { filter.Reset(first.orientation); }, rot);
+        for (size_t i = 0; i < times.size(); i++)
+        {
+            // time base shifted by one sampling interval to start the stabilizer with the first recorded value
+            const int64_t frameTime = times[i] + interval;
+            Dof input = values[i];
+            if (stabilizer)
+            {
+                for (; sampleTime <= frameTime; sampleTime += interval)
+                {
+                    Dof sample = Interpolate(times, values, sampleTime - interval);
+                    stabilizer->Insert(sample, sampleTime);
+                    stabilizer->Read(stabilized);
+                }
+                input = stabilized;
+            }
+            XrPosef pose = DofToPose(input);
+            std::visit([&pose, frameTime](auto& filter) { filter.Filter(pose.position, frameTime); }, trans);
+            std::visit([&pose, frameTime](auto& filter) { filter.Filter(pose.orientation, frameTime); }, rot);
+            samples[i] = {times[i], values[i], PoseToDof(pose)};
+        }
+        return true;
+    }
+
+    void Print(const std::string& name, const Result& result, const size_t count)
+    {
+        printf("%s", name.c_str());
+        if (result.time > 0.0)
+        {
+            printf(": %.1f ns/frame", result.time / static_cast<double>(count));
+        }
+        printf("\n");
+        for (int dof = 0; dof < 6; dof++)
+        {
+            printf("  %-5s lag = %6.1f ms (correlation = %.3f), jitter rms = %.4f -> %.4f %s\n",
+                   dofNames[dof],
+                   result.evaluation.lag[dof] / 1000000.0,
+                   result.evaluation.correlation[dof],
+                   result.evaluation.inputJitter[dof],
+                   result.evaluation.outputJitter[dof],
+                   dof < yaw ? "mm" : "deg");
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    openxr_api_layer::localAppData = options.config;
+    if (!GetConfig()->Init(""))
+    {
+        fprintf(stderr, "unable to load configuration from %s\n", options.config.string().c_str());
+        return 1;
+    }
+
+    std::vector<int64_t> times;
+    std::vector<Dof> unfiltered, filtered;
+    if (!Recording::Parse(options.recording, times, unfiltered, filtered))
+    {
+        fprintf(stderr, "unable to read recording: %s\n", options.recording.string().c_str());
+        return 1;
+    }
+    std::vector<EvaluationSample> samples(times.size());
+    for (size_t i = 0; i < times.size(); i++)
+    {
+        samples[i] = {times[i], unfiltered[i], filtered[i]};
+    }
+    Result recorded;
+    if (!EvaluateSamples(samples, recorded.evaluation))
+    {
+        fprintf(stderr, "too few samples in recording: %u\n", static_cast<uint32_t>(times.size()));
+        return 1;
+    }
+    printf("%u frames, %.1f s, mean interval = %.3f ms\n",
+           static_cast<uint32_t>(times.size()),
+           static_cast<double>(times.back()) / 1000000000.0,
+           recorded.evaluation.interval / 1000000.0);
+    Print("recorded", recorded, times.size());
+
+    for (const int stabilizerOrder : options.stabilizers)
+    {
+        // strength is irrelevant without stabilizer / filter
+        const std::vector<float> stabilizerStrengths =
+            stabilizerOrder ? options.stabilizerStrengths : std::vector<float>{0.f};
+        for (const float stabilizerStrength : stabilizerStrengths)
+        {
+            for (const std::string& type : options.filters)
+            {
+                const std::vector<float> strengths = "none" == type ? std::vector<float>{0.f} : options.strengths;
+                for (const float strength : strengths)
+                {
+                    std::string name = "none" == type ? type : fmt::format("{} {:.2f}", type, strength);
+                    if (stabilizerOrder)
+                    {
+                        name += fmt::format(", stabilizer order {} {:.2f}", stabilizerOrder, stabilizerStrength);
+                    }
+
+                    // use the fastest pass to reduce the influence of other processes
+                    Result result{{}, std::numeric_limits<double>::max()};
+                    for (int pass = 0; pass < options.passes; pass++)
+                    {
+                        const auto start = std::chrono::steady_clock::now();
+                        if (!Replay(times,
+                                    unfiltered,
+                                    type,
+                                    strength,
+                                    stabilizerOrder,
+                                    stabilizerStrength,
+                                    samples))
+                        {
+                            return 1;
+                        }
+                        const std::chrono::duration<double, std::nano> duration =
+                            std::chrono::steady_clock::now() - start;
+                        result.time = std::min(result.time, duration.count());
+                    }
+                    EvaluateSamples(samples, result.evaluation);
+                    Print(name, result, times.size());
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,612 @@
+// Copyright(c) 2024 Sebastian Veith
+
+// long running test of the input stabilizer sampling, outside of an OpenXR session
+// the sampler thread polls a synthetic data source (sine sweep, steps, noise, dropouts) or the memory mapped file of a
+// virtual tracker (e.g. written by oxrmc_mmf_writer) while frame threads call ReadData at the frame rate, optionally
+// along with threads stressing a ring buffer like the sampler history
+// sampling rate accuracy, ReadData latency, lock contention and cpu usage are reported periodically
+
+#include "pch.h"
+#include "config.h"
+#include "sampler.h"
+#include <log.h>
+
+namespace openxr_api_layer::log
+{
+    extern std::ofstream logStream;
+} // namespace openxr_api_layer::log
+
+using namespace sampler;
+using namespace utility;
+
+namespace
+{
+    struct Options
+    {
+        double duration{300.0};
+        double report{10.0};
+        std::string source{"synthetic"};
+        std::string signal{"mixed"};
+        float rate{60.f};
+        float noise{0.05f};
+        float dropouts{2.f};
+        float strength{0.5f};
+        int readers{1};
+        float fps{90.f};
+        float prediction{11.f};
+        int ringReaders{0};
+        std::filesystem::path log{"oxrmc_soak.log"};
+        std::vector<std::pair<std::string, std::string>> stabilizer{};
+    };
+
+    // statistics of one thread, guarded against concurrent reporting
+    struct ThreadStatistics
+    {
+        std::mutex mutex;
+        IntervalHistogram durations;
+        uint64_t failures{0};
+        int64_t cpuTime{0};
+        int64_t reportedCpuTime{0};
+    };
+
+    std::atomic_bool g_Running{true};
+
+    void PrintUsage()
+    {
+        printf("usage: oxrmc_soak [options]\n"
+               "  --duration <s>          test duration, default: 300\n"
+               "  --report <s>            reporting interval, default: 10\n"
+               "  --source <name>         synthetic (default) or the mmf of a virtual tracker: flypt, srs or yaw\n"
+               "  --signal <name>         synthetic signal: sweep, step, noise or mixed (default)\n"
+               "  --rate <Hz>             update rate of the synthetic source, default: 60\n"
+               "  --noise <factor>        noise relative to the signal amplitude, default: 0.05\n"
+               "  --dropouts <n>          dropouts (0.25 s freezes) per minute, default: 2\n"
+               "  --strength <value>      stabilizer strength, default: 0.5\n"
+               "  --readers <n>           frame threads calling ReadData, default: 1\n"
+               "  --fps <n>               frame rate of each reader, default: 90\n"
+               "  --prediction <ms>       display time ahead of the read, default: 11\n"
+               "  --ring_readers <n>      threads reading a ring buffer without pause while it is written at the "
+               "sampling rate, default: 0\n"
+               "  --log <file>            log file receiving the sampler statistics, default: oxrmc_soak.log\n"
+               "  --<key> <value>         any key of [input_stabilizer], e.g. --sample_interval 1.0 "
+               "--precise_timing 1\n");
+    }
+
+    bool ParseOptions(const int argc, char** argv, Options& options)
+    {
+        if (0 == argc % 2)
+        {
+            return false;
+        }
+        try
+        {
+            for (int i = 1; i + 1 < argc; i += 2)
+            {
+                const std::string option(argv[i]), value(argv[i + 1]);
+                if (!option.starts_with("--"))
+                {
+                    return false;
+                }
+                const std::string key = option.substr(2);
+                if ("duration" == key)
+                {
+                    options.duration = std::stod(value);
+                }
+                else if ("report" == key)
+                {
+                    options.report = std::max(std::stod(value), 0.1);
+                }
+                else if ("source" == key)
+                {
+                    options.source = value;
+                }
+                else if ("signal" == key)
+                {
+                    options.signal = value;
+                }
+                else if ("rate" == key)
+                {
+                    options.rate = std::stof(value);
+                }
+                else if ("noise" == key)
+                {
+                    options.noise = std::stof(value);
+                }
+                else if ("dropouts" == key)
+                {
+                    options.dropouts = std::stof(value);
+                }
+                else if ("strength" == key)
+                {
+                    options.strength = std::stof(value);
+                }
+                else if ("readers" == key)
+                {
+                    options.readers = std::max(std::stoi(value), 0);
+                }
+                else if ("fps" == key)
+                {
+                    options.fps = std::max(std::stof(value), 1.f);
+                }
+                else if ("prediction" == key)
+                {
+                    options.prediction = std::stof(value);
+                }
+                else if ("ring_readers" == key)
+                {
+                    options.ringReaders = std::max(std::stoi(value), 0);
+                }
+                else if ("log" == key)
+                {
+                    options.log = value;
+                }
+                else
+                {
+                    options.stabilizer.emplace_back(key, value);
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            fprintf(stderr, "invalid option value: %s\n", e.what());
+            return false;
+        }
+        return true;
+    }
+
+    int64_t Now()
+    {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    // kernel and user time of the calling thread, in ns
+    int64_t ThreadCpuTime()
+    {
+        FILETIME creation, exit, kernel, user;
+        if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        {
+            return 0;
+        }
+        const auto ToNanoseconds = [](const FILETIME& time) {
+            return ((static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100;
+        };
+        return ToNanoseconds(kernel) + ToNanoseconds(user);
+    }
+
+    // xr time is steady clock time within the harness, as the performance counter on windows
+    XrResult ConvertTime(XrInstance, const XrTime time, LARGE_INTEGER* counter)
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        counter->QuadPart = time / 1000000 * frequency.QuadPart / 1000 +
+                            time % 1000000 * frequency.QuadPart / 1000000000;
+        return XR_SUCCESS;
+    }
+
+    XrResult GetInstanceProcAddr(XrInstance, const char* name, PFN_xrVoidFunction* function)
+    {
+        if (std::string("xrConvertTimeToWin32PerformanceCounterKHR") != name)
+        {
+            return XR_ERROR_FUNCTION_UNSUPPORTED;
+        }
+        *function = reinterpret_cast<PFN_xrVoidFunction>(&ConvertTime);
+        return XR_SUCCESS;
+    }
+
+    // data source measuring the sampling cycles on the sampler thread
+    // cycles taking more than twice the sampling interval are counted as failures
+    class SoakSource : public SampleSource
+    {
+      public:
+        explicit SoakSource(const int64_t interval) : m_Interval(interval)
+        {
+            m_Statistics.durations.SetResolution(interval / 50);
+        }
+
+        bool ReadSource(const XrTime time, Dof& dof) override
+        {
+            const int64_t now = Now();
+            {
+                std::unique_lock lock(m_Statistics.mutex);
+                if (m_LastRead > 0)
+                {
+                    m_Statistics.durations.Add(now - m_LastRead);
+                    m_Statistics.failures += now - m_LastRead > 2 * m_Interval ? 1 : 0;
+                }
+                m_LastRead = now;
+                m_Statistics.cpuTime = ThreadCpuTime();
+            }
+            return ReadDof(time, dof);
+        }
+
+        ThreadStatistics m_Statistics;
+
+      protected:
+        virtual bool ReadDof(XrTime time, Dof& dof) = 0;
+
+      private:
+        const int64_t m_Interval;
+        int64_t m_LastRead{0};
+    };
+
+    class SyntheticSource final : public SoakSource
+    {
+      public:
+        SyntheticSource(const Options& options, const int64_t interval) : SoakSource(interval)
+        {
+            m_Synthetic.Configure(options.signal, options.rate, options.noise, options.dropouts);
+        }
+
+        DataSource* GetSource() override
+        {
+            return &m_Synthetic;
+        }
+
+      protected:
+        bool ReadDof(const XrTime time, Dof& dof) override
+        {
+            return m_Synthetic.Read(&dof, sizeof(Dof), time);
+        }
+
+      private:
+        Synthetic m_Synthetic;
+    };
+
+    // same layouts as SixDofTracker::SixDof and YawTracker::YawData
+    struct SixDof
+    {
+        double sway, surge, heave, yaw, roll, pitch;
+    };
+
+    struct YawData
+    {
+        float yaw, pitch, roll, battery, rotationHeight, rotationForwardHead;
+        bool sixDof, usePos;
+        float autoX, autoY;
+    };
+
+    // memory mapped file of a virtual tracker, converted to dof values the same way as by the tracker
+    class MmfSource final : public SoakSource
+    {
+      public:
+        MmfSource(const std::string& name, const bool yawLayout, const int64_t interval)
+            : SoakSource(interval), m_YawLayout(yawLayout)
+        {
+            m_Mmf.SetName(name);
+        }
+
+        DataSource* GetSource() override
+        {
+            return &m_Mmf;
+        }
+
+      protected:
+        bool ReadDof(const XrTime time, Dof& dof) override
+        {
+            if (m_YawLayout)
+            {
+                YawData mmfData{};
+                if (!m_Mmf.Read(&mmfData, sizeof(mmfData), time))
+                {
+                    return false;
+                }
+                dof = {0.f, 0.f, 0.f, mmfData.yaw, mmfData.roll, mmfData.pitch};
+                return true;
+            }
+            SixDof mmfData{};
+            if (!m_Mmf.Read(&mmfData, sizeof(mmfData), time))
+            {
+                return false;
+            }
+            dof.data[sway] = static_cast<float>(mmfData.sway);
+            dof.data[surge] = static_cast<float>(mmfData.surge);
+            dof.data[heave] = static_cast<float>(mmfData.heave);
+            dof.data[yaw] = static_cast<float>(mmfData.yaw);
+            dof.data[pitch] = static_cast<float>(mmfData.pitch);
+            dof.data[roll] = static_cast<float>(mmfData.roll);
+            return true;
+        }
+
+      private:
+        Mmf m_Mmf;
+        const bool m_YawLayout;
+    };
+
+    // mmf names as used by the virtual trackers
+    bool GetName(const std::string& tracker, std::string& name)
+    {
+        if ("flypt" == tracker)
+        {
+            name = "Local\\motionRigPose";
+        }
+        else if ("srs" == tracker)
+        {
+            name = "Local\\SimRacingStudioMotionRigPose";
+        }
+        else if ("yaw" == tracker)
+        {
+            name = "Local\\YawVRGEFile";
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    void RunFrameReader(Sampler& sampler, ThreadStatistics& statistics, const Options& options)
+    {
+        const auto period = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / options.fps));
+        const auto prediction = static_cast<int64_t>(options.prediction * 1000000.f);
+        auto next = std::chrono::steady_clock::now();
+        while (g_Running.load())
+        {
+            const int64_t start = Now();
+            Dof dof;
+            const bool success = sampler.ReadData(dof, start + prediction);
+            const int64_t duration = Now() - start;
+            {
+                std::unique_lock lock(statistics.mutex);
+                statistics.durations.Add(duration);
+                statistics.failures += success ? 0 : 1;
+                statistics.cpuTime = ThreadCpuTime();
+            }
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    // same capacity and lookup as the sampler history, written at the sampling interval
+    void RunRingWriter(RingBuffer<Dof>& ring, ThreadStatistics& statistics, const int64_t interval)
+    {
+        auto next = std::chrono::steady_clock::now();
+        Dof dof{};
+        while (g_Running.load())
+        {
+            const int64_t start = Now();
+            bool existing;
+            dof.data[sway] += 1.f;
+            ring.Insert(start, dof, true, existing);
+            const int64_t duration = Now() - start;
+            {
+                std::unique_lock lock(statistics.mutex);
+                statistics.durations.Add(duration);
+                statistics.cpuTime = ThreadCpuTime();
+            }
+            next += std::chrono::nanoseconds(interval);
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    void RunRingReader(const RingBuffer<Dof>& ring, ThreadStatistics& statistics)
+    {
+        uint64_t count{0};
+        while (g_Running.load())
+        {
+            const int64_t start = Now();
+            Neighborhood<Dof> neighborhood;
+            ring.Bracket(start, 8, neighborhood);
+            const int64_t duration = Now() - start;
+            std::unique_lock lock(statistics.mutex);
+            statistics.durations.Add(duration);
+            // reduce overhead of the cpu time query
+            if (0 == ++count % 1024)
+            {
+                statistics.cpuTime = ThreadCpuTime();
+            }
+        }
+    }
+
+    // accumulated over a group of threads since the last report
+    struct GroupReport
+    {
+        // take over and reset the statistics of one thread
+        void Add(ThreadStatistics& statistics, const int64_t elapsed)
+        {
+            std::unique_lock lock(statistics.mutex);
+            const uint64_t added = statistics.durations.GetCount();
+            count += added;
+            total += static_cast<double>(statistics.durations.GetMean()) * static_cast<double>(added);
+            // percentile of the worst thread, histograms are not merged
+            p99 = std::max(p99, statistics.durations.GetPercentile(0.99));
+            max = std::max(max, statistics.durations.GetMax());
+            failures += statistics.failures;
+            cpu += 100.0 * static_cast<double>(statistics.cpuTime - statistics.reportedCpuTime) /
+                   static_cast<double>(elapsed);
+            statistics.reportedCpuTime = statistics.cpuTime;
+            statistics.durations.Clear();
+            statistics.failures = 0;
+        }
+
+        void Add(std::deque<ThreadStatistics>& group, const int64_t elapsed)
+        {
+            for (ThreadStatistics& statistics : group)
+            {
+                Add(statistics, elapsed);
+            }
+        }
+
+        [[nodiscard]] double Mean() const
+        {
+            return count > 0 ? total / static_cast<double>(count) : 0.0;
+        }
+
+        uint64_t count{0};
+        double total{0.0};
+        int64_t p99{0};
+        int64_t max{0};
+        uint64_t failures{0};
+        double cpu{0.0};
+    };
+
+    void Report(const double time,
+                const int64_t elapsed,
+                const int64_t interval,
+                SoakSource& source,
+                std::deque<ThreadStatistics>& readers,
+                std::deque<ThreadStatistics>& ringWriters,
+                std::deque<ThreadStatistics>& ringReaders,
+                const RingBuffer<Dof>& ring)
+    {
+        GroupReport sampling;
+        sampling.Add(source.m_Statistics, elapsed);
+        printf("[%6.0f s] sampling: %llu cycles, rate = %.1f Hz (target %.1f Hz), interval mean = %.3f ms, "
+               "p99 = %.3f ms, max = %.3f ms, %llu late (> 2 intervals), cpu = %.2f %%\n",
+               time,
+               static_cast<unsigned long long>(sampling.count),
+               static_cast<double>(sampling.count) * 1e9 / static_cast<double>(elapsed),
+               1e9 / static_cast<double>(interval),
+               sampling.Mean() / 1e6,
+               static_cast<double>(sampling.p99) / 1e6,
+               static_cast<double>(sampling.max) / 1e6,
+               static_cast<unsigned long long>(sampling.failures),
+               sampling.cpu);
+        if (!readers.empty())
+        {
+            GroupReport reads;
+            reads.Add(readers, elapsed);
+            printf("           read data: %llu calls (%llu failed), mean = %.3f us, p99 = %.3f us, max = %.3f us, "
+                   "cpu = %.2f %%\n",
+                   static_cast<unsigned long long>(reads.count),
+                   static_cast<unsigned long long>(reads.failures),
+                   reads.Mean() / 1e3,
+                   static_cast<double>(reads.p99) / 1e3,
+                   static_cast<double>(reads.max) / 1e3,
+                   reads.cpu);
+        }
+        if (!ringReaders.empty())
+        {
+            GroupReport writes, lookups;
+            writes.Add(ringWriters, elapsed);
+            lookups.Add(ringReaders, elapsed);
+            printf("           ring buffer: %llu inserts, mean = %.3f us, max = %.3f us, %llu lookups, mean = %.3f us, "
+                   "p99 = %.3f us, max = %.3f us, cpu = %.2f %%\n",
+                   static_cast<unsigned long long>(writes.count),
+                   writes.Mean() / 1e3,
+                   static_cast<double>(writes.max) / 1e3,
+                   static_cast<unsigned long long>(lookups.count),
+                   lookups.Mean() / 1e3,
+                   static_cast<double>(lookups.p99) / 1e3,
+                   static_cast<double>(lookups.max) / 1e3,
+                   writes.cpu + lookups.cpu);
+            printf("           ring buffer contention (total): %llu read retries, %llu locked reads, %llu lock waits\n",
+                   static_cast<unsigned long long>(ring.GetReadRetries()),
+                   static_cast<unsigned long long>(ring.GetLockedReads()),
+                   static_cast<unsigned long long>(ring.GetLockWaits()));
+        }
+        fflush(stdout);
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    std::string mmfName;
+    if (!ParseOptions(argc, argv, options) ||
+        ("synthetic" != options.source && !GetName(options.source, mmfName)))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    // default configuration with the sampler statistics logged at the reporting interval
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "oxrmc_soak";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::copy_file(OXRMC_DEFAULT_CONFIG, directory / "OpenXR-MotionCompensation.ini");
+    const std::string appConfig = (directory / "soak.ini").string();
+    const std::string reportInterval = std::to_string(options.report);
+    WritePrivateProfileString("debug", "sampler_statistics_interval", reportInterval.c_str(), appConfig.c_str());
+    for (const auto& [key, value] : options.stabilizer)
+    {
+        WritePrivateProfileString("input_stabilizer", key.c_str(), value.c_str(), appConfig.c_str());
+    }
+    openxr_api_layer::localAppData = directory;
+    openxr_api_layer::log::logStream.open(options.log);
+    if (!GetConfig()->Init("soak"))
+    {
+        fprintf(stderr, "unable to load configuration from %s\n", directory.string().c_str());
+        return 1;
+    }
+    GetTimeConverter()->Init(XR_NULL_HANDLE, &GetInstanceProcAddr);
+    float intervalMs{1.f};
+    GetConfig()->GetFloat(Cfg::StabilizerInterval, intervalMs);
+    const int64_t interval = std::max(static_cast<int64_t>(intervalMs * 1000.f), int64_t{1}) * 1000;
+
+    const std::vector<DofValue> relevant{sway, surge, heave, yaw, roll, pitch};
+    std::unique_ptr<SoakSource> source;
+    if (mmfName.empty())
+    {
+        source = std::make_unique<SyntheticSource>(options, interval);
+    }
+    else
+    {
+        source = std::make_unique<MmfSource>(mmfName, "yaw" == options.source, interval);
+        if (!source->GetSource()->Open(Now()))
+        {
+            fprintf(stderr, "unable to open mmf %s, start oxrmc_mmf_writer --tracker %s first\n",
+                    mmfName.c_str(),
+                    options.source.c_str());
+            return 1;
+        }
+    }
+    Sampler sampler(source.get(), relevant, nullptr);
+    sampler.SetStrength(options.strength);
+    sampler.StartSampling();
+
+    std::deque<ThreadStatistics> readers, ringWriters, ringReaders;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.readers; i++)
+    {
+        readers.emplace_back().durations.SetResolution(100);
+        threads.emplace_back(RunFrameReader, std::ref(sampler), std::ref(readers.back()), std::cref(options));
+    }
+    RingBuffer<Dof> ring(128);
+    if (options.ringReaders > 0)
+    {
+        ringWriters.emplace_back().durations.SetResolution(100);
+        threads.emplace_back(RunRingWriter, std::ref(ring), std::ref(ringWriters.back()), interval);
+        for (int i = 0; i < options.ringReaders; i++)
+        {
+            ringReaders.emplace_back().durations.SetResolution(10);
+            threads.emplace_back(RunRingReader, std::cref(ring), std::ref(ringReaders.back()));
+        }
+    }
+
+    printf("%s source, sampling interval = %.3f ms, %d frame reader(s) at %.0f fps, %d ring buffer reader(s), sampler "
+           "statistics are logged to %s\n",
+           options.source.c_str(),
+           static_cast<double>(interval) / 1e6,
+           options.readers,
+           options.fps,
+           options.ringReaders,
+           options.log.string().c_str());
+    fflush(stdout);
+    const std::chrono::nanoseconds period(static_cast<int64_t>(options.report * 1e9));
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + std::chrono::nanoseconds(static_cast<int64_t>(options.duration * 1e9));
+    auto previous = start;
+    for (auto next = start + period; next <= end; next += period)
+    {
+        std::this_thread::sleep_until(next);
+        const auto now = std::chrono::steady_clock::now();
+        Report(std::chrono::duration<double>(now - start).count(),
+               std::chrono::duration_cast<std::chrono::nanoseconds>(now - previous).count(),
+               interval,
+               *source,
+               readers,
+               ringWriters,
+               ringReaders,
+               ring);
+        previous = now;
+    }
+
+    g_Running = false;
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    sampler.StopSampling();
+    std::filesystem::remove_all(directory);
+    return 0;
+}